@@ -0,0 +1,407 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Asynchronous HDF5 snapshot writer.
+
+  Snapshots of the primitive variables are written by a dedicated
+  writer thread (one per rank), so that the time integration does not
+  wait for the disk.
+  AsyncH5Write() copies the interior zones of all the variables into a
+  staging slot and queues it; the writer thread then saves it to
+  <tt>async.NNNN.h5</tt> (<tt>async.NNNN.rRRRR.h5</tt>, one file per
+  rank, in parallel) in the output directory, with one dataset per
+  variable and the time, global offset and global size as attributes.
+
+  Staging memory is bounded by ::ASYNC_H5_SLOTS slots: when all of
+  them are still queued, AsyncH5Write() waits for the oldest one to be
+  written.
+  AsyncH5Flush() waits until every queued snapshot is on disk; it is
+  called for checkpoint snapshots and at exit.
+
+  Snapshots are taken by AsyncH5Check(), called from Analysis(), with
+  the cadence given by the \c async.h5 line of pluto.ini:
+  \verbatim
+  async.h5   <dt>   <dt_checkpoint>
+  \endverbatim
+  where a negative \c dt_checkpoint disables checkpoint flushes.
+  Snapshot times are therefore rounded to the \c analysis interval.
+  The writer is opt-in: the default setup keeps the core \c dbl.h5
+  output and leaves ::ASYNC_H5 off.
+
+  Datasets are chunked and compressed with the per-variable settings
+  of the core .h5 output (\c h5_compress.* lines of pluto.ini, see
+  hdf5_io.c). Write time and compression ratio are reported in the
+  log; with \c h5_readback set to 1 every file is also read back and
+  the maximum error per variable is reported.
+  The writer thread is the only one calling the HDF5 library: core
+  .h5 output should be disabled (or HDF5 built thread-safe), and
+  checkpoints taken with the binary \c dbl format.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#ifdef USE_HDF5
+ #include <hdf5.h>
+#endif
+#include "local_pluto.h"
+
+#if (ASYNC_H5 == YES) && defined(USE_HDF5)
+
+#include <pthread.h>
+#include <time.h>
+
+typedef struct AsyncSlot_{
+  int    nfile;        /* Snapshot number                    */
+  double time;         /* Simulation time                    */
+  int    nx[3];        /* Local interior size (i, j, k)      */
+  int    offset[3];    /* Global offset of the local block   */
+  int    nx_glob[3];   /* Global size                        */
+  double *buf;         /* NVAR contiguous blocks [k][j][i]   */
+} AsyncSlot;
+
+typedef struct AsyncReport_{
+  int    nfile;
+  double wtime;             /* Write time (s)                    */
+  double raw, stored;       /* Raw and stored size (bytes)       */
+  double err[NVAR];         /* Maximum read-back error           */
+} AsyncReport;
+
+static AsyncSlot slot[ASYNC_H5_SLOTS];
+static AsyncReport report[ASYNC_H5_SLOTS];
+static int  nreport, readback;
+static int  queue[ASYNC_H5_SLOTS], qhead, qcount, nfree;
+static int  free_list[ASYNC_H5_SLOTS];
+static int  started, shutdown_writer;
+static char out_dir[512];
+
+static pthread_t       writer;
+static pthread_mutex_t lock      = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  cond_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  cond_done = PTHREAD_COND_INITIALIZER;
+
+static void *AsyncH5Writer (void *);
+static void  AsyncH5WriteSlot (AsyncSlot *, AsyncReport *);
+static void  AsyncH5Finalize (void);
+static void  AsyncH5PrintReports (void);
+
+/* ********************************************************************* */
+void AsyncH5Check (const Data *d, Grid *grid)
+/*!
+ * Queue a snapshot when a multiple of the async.h5 interval has been
+ * reached since the last one. A snapshot that also reaches a
+ * checkpoint time is flushed before returning.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  static int    last_snap = -1, last_chk = -1;
+  static double dt_snap = -1.0, dt_chk = -1.0;
+  int n, nchk, checkpoint = 0;
+
+  if (last_snap == -1 && dt_snap < 0.0){
+    if (!ParamExist ("async.h5")) return;
+    dt_snap = atof(ParamFileGet("async.h5", 1));
+    dt_chk  = atof(ParamFileGet("async.h5", 2));
+  }
+  if (dt_snap <= 0.0) return;
+
+  n = (int)floor(g_time/dt_snap + 1.e-9);
+  if (n <= last_snap) return;
+  last_snap = n;
+
+  if (dt_chk > 0.0){
+    nchk = (int)floor(g_time/dt_chk + 1.e-9);
+    if (nchk > last_chk) {
+      checkpoint = 1;
+      last_chk   = nchk;
+    }
+  }
+  AsyncH5Write (d, n, checkpoint, grid);
+}
+
+/* ********************************************************************* */
+void AsyncH5Write (const Data *d, int nfile, int checkpoint, Grid *grid)
+/*!
+ * Copy the interior of d->Vc into a free staging slot and queue it
+ * for writing.
+ *
+ * \param [in] d           pointer to PLUTO Data structure
+ * \param [in] nfile       the snapshot number
+ * \param [in] checkpoint  when != 0, wait until the snapshot is written
+ * \param [in] grid        pointer to Grid structure
+ *********************************************************************** */
+{
+  int  s, dir, nv;
+  long ncell;
+  AsyncSlot *sl;
+
+/* --------------------------------------------------------
+   1. Start the writer thread at the first call
+   -------------------------------------------------------- */
+
+  if (!started){
+    ncell = (long)NX1*NX2*NX3;
+    for (s = 0; s < ASYNC_H5_SLOTS; s++){
+      slot[s].buf  = ARRAY_1D(NVAR*ncell, double);
+      free_list[s] = s;
+    }
+    nfree = ASYNC_H5_SLOTS;
+    sprintf (out_dir, "%s", RuntimeGet()->output_dir);
+    H5CompressInit ();
+    readback = H5CompressReadBack ();
+
+  /* -- Initialize HDF5 here, so that its own exit handler is
+        registered first and runs after AsyncH5Finalize() -- */
+
+    H5open ();
+    if (pthread_create (&writer, NULL, AsyncH5Writer, NULL) != 0){
+      printLog ("! AsyncH5Write(): cannot create writer thread\n");
+      QUIT_PLUTO(1);
+    }
+    atexit (AsyncH5Finalize);
+    started = 1;
+  }
+
+/* --------------------------------------------------------
+   2. Take a free slot (wait if all are queued)
+   -------------------------------------------------------- */
+
+  pthread_mutex_lock (&lock);
+  while (nfree == 0) pthread_cond_wait (&cond_done, &lock);
+  s = free_list[--nfree];
+  pthread_mutex_unlock (&lock);
+  AsyncH5PrintReports ();
+
+/* --------------------------------------------------------
+   3. Stage the data
+   -------------------------------------------------------- */
+
+  sl = slot + s;
+  sl->nfile = nfile;
+  sl->time  = g_time;
+  sl->nx[IDIR] = NX1; sl->nx[JDIR] = NX2; sl->nx[KDIR] = NX3;
+  for (dir = 0; dir < 3; dir++){
+    sl->offset[dir]  = (dir < DIMENSIONS ? grid->beg[dir] - grid->nghost[dir] : 0);
+    sl->nx_glob[dir] = grid->np_int_glob[dir];
+  }
+
+  for (nv = 0; nv < NVAR; nv++){
+    double *q = sl->buf + (long)nv*NX1*NX2*NX3;
+    int    k;
+
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (k = KBEG; k <= KEND; k++){
+      int i, j;
+      for (j = JBEG; j <= JEND; j++){
+        double *p = q + ((long)(k - KBEG)*NX2 + (j - JBEG))*NX1;
+        for (i = IBEG; i <= IEND; i++) p[i - IBEG] = d->Vc[nv][k][j][i];
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+   4. Queue it
+   -------------------------------------------------------- */
+
+  pthread_mutex_lock (&lock);
+  queue[(qhead + qcount)%ASYNC_H5_SLOTS] = s;
+  qcount++;
+  pthread_cond_signal (&cond_work);
+  pthread_mutex_unlock (&lock);
+
+  if (checkpoint) AsyncH5Flush ();
+}
+
+/* ********************************************************************* */
+void AsyncH5Flush (void)
+/*!
+ * Wait until all queued snapshots have been written.
+ *********************************************************************** */
+{
+  if (!started) return;
+  pthread_mutex_lock (&lock);
+  while (qcount > 0) pthread_cond_wait (&cond_done, &lock);
+  pthread_mutex_unlock (&lock);
+  AsyncH5PrintReports ();
+}
+
+/* ********************************************************************* */
+static void AsyncH5PrintReports (void)
+/*!
+ * Write the reports of the snapshots completed so far to the log.
+ * Called by the main thread only.
+ *********************************************************************** */
+{
+  int n, nv, nr;
+  AsyncReport r[ASYNC_H5_SLOTS];
+  char vname[32];
+
+  pthread_mutex_lock (&lock);
+  nr = nreport;
+  for (n = 0; n < nr; n++) r[n] = report[n];
+  nreport = 0;
+  pthread_mutex_unlock (&lock);
+
+  for (n = 0; n < nr; n++){
+    printLog ("> async.%04d.h5: %.3f s, %.1f MB -> %.1f MB (ratio %.2f)\n",
+              r[n].nfile, r[n].wtime, r[n].raw/1.e6, r[n].stored/1.e6,
+              r[n].raw/MAX(r[n].stored, 1.0));
+    if (!readback) continue;
+    printLog ("  max read-back error:");
+    for (nv = 0; nv < NVAR; nv++){
+      OutputVarName (nv, vname);
+      printLog (" %s %.2e", vname, r[n].err[nv]);
+    }
+    printLog ("\n");
+  }
+}
+
+/* ********************************************************************* */
+static void AsyncH5Finalize (void)
+/*!
+ * Flush the queue and stop the writer thread (registered with
+ * atexit()).
+ *********************************************************************** */
+{
+  AsyncH5Flush ();
+  pthread_mutex_lock (&lock);
+  shutdown_writer = 1;
+  pthread_cond_signal (&cond_work);
+  pthread_mutex_unlock (&lock);
+  pthread_join (writer, NULL);
+}
+
+/* ********************************************************************* */
+static void *AsyncH5Writer (void *arg)
+/*!
+ * Writer thread: write queued slots in order and release them.
+ *********************************************************************** */
+{
+  int s;
+  AsyncReport rep;
+
+  for (;;){
+    pthread_mutex_lock (&lock);
+    while (qcount == 0 && !shutdown_writer) {
+      pthread_cond_wait (&cond_work, &lock);
+    }
+    if (qcount == 0){
+      pthread_mutex_unlock (&lock);
+      break;
+    }
+    s = queue[qhead];
+    pthread_mutex_unlock (&lock);
+
+    AsyncH5WriteSlot (slot + s, &rep);
+
+  /* -- Release the slot only once written (AsyncH5Flush()) -- */
+
+    pthread_mutex_lock (&lock);
+    if (nreport < ASYNC_H5_SLOTS) report[nreport++] = rep;
+    qhead = (qhead + 1)%ASYNC_H5_SLOTS;
+    qcount--;
+    free_list[nfree++] = s;
+    pthread_cond_broadcast (&cond_done);
+    pthread_mutex_unlock (&lock);
+  }
+  return NULL;
+}
+
+/* ********************************************************************* */
+static void AsyncH5WriteSlot (AsyncSlot *sl, AsyncReport *rep)
+/*!
+ * Write one staging slot to disk, read it back (h5_readback) and fill
+ * the report.
+ *********************************************************************** */
+{
+  int     nv;
+  long    l, ncell = (long)sl->nx[IDIR]*sl->nx[JDIR]*sl->nx[KDIR];
+  char    fname[640], vname[32];
+  double  t0, *check;
+  hid_t   file, space, dset, aspace, attr, dcpl;
+  hsize_t dims[3], three = 3;
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  t0 = ts.tv_sec + 1.e-9*ts.tv_nsec;
+  memset (rep, 0, sizeof(AsyncReport));
+  rep->nfile = sl->nfile;
+
+  #ifdef PARALLEL
+  sprintf (fname, "%s/async.%04d.r%04d.h5", out_dir, sl->nfile, prank);
+  #else
+  sprintf (fname, "%s/async.%04d.h5", out_dir, sl->nfile);
+  #endif
+
+  file = H5Fcreate (fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file < 0){
+    fprintf (stderr, "! AsyncH5WriteSlot(): cannot create %s\n", fname);
+    return;
+  }
+
+/* -- Attributes: time, offset and size of the global grid -- */
+
+  aspace = H5Screate (H5S_SCALAR);
+  attr   = H5Acreate2 (file, "time", H5T_NATIVE_DOUBLE, aspace,
+                       H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite (attr, H5T_NATIVE_DOUBLE, &sl->time);
+  H5Aclose (attr);
+  H5Sclose (aspace);
+
+  aspace = H5Screate_simple (1, &three, NULL);
+  attr   = H5Acreate2 (file, "offset", H5T_NATIVE_INT, aspace,
+                       H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite (attr, H5T_NATIVE_INT, sl->offset);
+  H5Aclose (attr);
+  attr   = H5Acreate2 (file, "global_size", H5T_NATIVE_INT, aspace,
+                       H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite (attr, H5T_NATIVE_INT, sl->nx_glob);
+  H5Aclose (attr);
+  H5Sclose (aspace);
+
+/* -- One dataset per variable, dimensions (k,j,i) -- */
+
+  dims[0] = sl->nx[KDIR]; dims[1] = sl->nx[JDIR]; dims[2] = sl->nx[IDIR];
+  space = H5Screate_simple (3, dims, NULL);
+  for (nv = 0; nv < NVAR; nv++){
+    OutputVarName (nv, vname);
+    dcpl = H5CompressDcpl (vname, 3, dims);
+    dset = H5Dcreate2 (file, vname, H5T_NATIVE_DOUBLE, space,
+                       H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dwrite (dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+              sl->buf + nv*ncell);
+    rep->stored += (double)H5Dget_storage_size (dset);
+    rep->raw    += (double)ncell*sizeof(double);
+    H5Dclose (dset);
+    if (dcpl != H5P_DEFAULT) H5Pclose (dcpl);
+  }
+  H5Sclose (space);
+  H5Fclose (file);
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  rep->wtime = ts.tv_sec + 1.e-9*ts.tv_nsec - t0;
+
+/* -- Read back and compare with the staged data -- */
+
+  if (!readback) return;
+  check = (double *) malloc(ncell*sizeof(double));
+  file  = H5Fopen (fname, H5F_ACC_RDONLY, H5P_DEFAULT);
+  for (nv = 0; nv < NVAR && file >= 0; nv++){
+    double *q = sl->buf + nv*ncell, err = 0.0;
+
+    OutputVarName (nv, vname);
+    dset = H5Dopen2 (file, vname, H5P_DEFAULT);
+    H5Dread (dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, check);
+    H5Dclose (dset);
+    for (l = 0; l < ncell; l++) err = MAX(err, fabs(check[l] - q[l]));
+    rep->err[nv] = err;
+  }
+  if (file >= 0) H5Fclose (file);
+  free (check);
+}
+
+#endif /* (ASYNC_H5 == YES) && defined(USE_HDF5) */
@@ -0,0 +1,392 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Standalone driver of the parabolic kernel benchmark.
+
+  Builds the setup sources against the stand-in headers of pluto.h
+  and runs ParabolicBench() (parabolic_bench.c) on a uniform,
+  periodic Cartesian grid holding the initial KH fields (InitDomain()),
+  without PLUTO and without running a simulation:
+  \verbatim
+  make [NTRACER=<n>]            # builds ./bench_ntr<n>
+  ./bench_ntr<n> [<nx1> [<nx2> [<nrep>]]]
+  make sweep                    # NTRACER = 1 2 4 8, default sizes
+  \endverbatim
+  The grid size defaults to 512 x 1024 (nx1 only in 1D, nx1^3 in 3D),
+  and \c nrep, the repetitions of every measurement, to 5.
+  Physical parameters are read from the [Parameters] block of
+  pluto.ini, in the working directory or else in its parent (the
+  setup directory when run from bench/).
+  Tracers beyond the first start as copies of it.
+
+  Only this file provides PLUTO functions: arrays, pluto.ini access,
+  log output and periodic boundaries. The core TC_RHS(), ViscousRHS()
+  and ResistiveRHS() are not available, so conduction and viscosity
+  are timed through the fused kernel (PARABOLIC_FUSED) only.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+#include <stdarg.h>
+
+#define BENCH_NGHOST    2
+#define BENCH_MAX_LINES 512
+
+int    IBEG, IEND, JBEG, JEND, KBEG, KEND;
+int    NX1, NX2, NX3, NX1_TOT, NX2_TOT, NX3_TOT;
+int    NX1_MAX, NX2_MAX, NX3_MAX, NMAX_POINT;
+int    g_dir, g_i, g_j, g_k, g_intStage = 1, prank = 0;
+long   g_stepNumber;
+double g_time, g_dt, g_gamma = 5./3., g_inputParam[32];
+
+static Runtime runtime;
+static char   *ini_line[BENCH_MAX_LINES];
+static int     ini_nlines;
+
+static void BenchSetup (int *, Grid *, Data *);
+static void BenchDiffusionOnly (const char *);
+
+/* ********************************************************************* */
+int main (int argc, char *argv[])
+/*!
+ * Set up grid, data and parameters and run the benchmark.
+ *********************************************************************** */
+{
+  int  n, nrep = 5, nx[3] = {512, 1024, 1};
+  char *par[] = {"DEL_RHO_BY_RHO0", "REYNOLDS", "AMP", "Y1", "Y2",
+                 "SIGMA", "TANH_A", "U_FLOW", "RHO0", "PRS0", "LENGTH",
+                 "DIFFUSION"};
+  int  ipar[]  = {DEL_RHO_BY_RHO0, REYNOLDS, AMP, Y1, Y2, SIGMA, TANH_A,
+                  U_FLOW, RHO0, PRS0, LENGTH, DIFFUSION};
+  Grid grid;
+  Data d;
+  FILE *fp;
+
+  if (argc > 1) nx[IDIR] = atoi(argv[1]);
+  if (argc > 2) nx[JDIR] = atoi(argv[2]);
+  if (argc > 3) nrep     = atoi(argv[3]);
+  if (DIMENSIONS == 3) nx[KDIR] = nx[IDIR];
+
+  fp = fopen("pluto.ini", "r");
+  if (fp != NULL) fclose (fp);
+  ParamFileRead (fp != NULL ? "pluto.ini" : "../pluto.ini");
+  for (n = 0; n < (int)(sizeof(ipar)/sizeof(ipar[0])); n++){
+    g_inputParam[ipar[n]] = atof(ParamFileGet(par[n], 1));
+  }
+
+  BenchSetup (nx, &grid, &d);
+  printLog ("> Standalone parabolic benchmark, grid %d x %d x %d\n",
+            NX1, NX2, NX3);
+  ParabolicBench (&d, nrep, &grid);
+  return 0;
+}
+
+/* ********************************************************************* */
+static void BenchSetup (int *nx, Grid *grid, Data *d)
+/*!
+ * Build a uniform periodic grid of nx zones on the KH box
+ * [0,1] x [0,2] x [0,1], allocate the data and assign the initial
+ * condition.
+ *********************************************************************** */
+{
+  int    dir, i, j, k, nv, ng[3], tot[3];
+  double L[3] = {1.0, 2.0, 1.0}, dx;
+
+  for (dir = 0; dir < 3; dir++){
+    if (dir >= DIMENSIONS) nx[dir] = 1;
+    ng[dir]  = (dir < DIMENSIONS ? BENCH_NGHOST : 0);
+    tot[dir] = nx[dir] + 2*ng[dir];
+  }
+  NX1 = nx[IDIR]; NX1_TOT = NX1_MAX = tot[IDIR];
+  NX2 = nx[JDIR]; NX2_TOT = NX2_MAX = tot[JDIR];
+  NX3 = nx[KDIR]; NX3_TOT = NX3_MAX = tot[KDIR];
+  IBEG = ng[IDIR]; IEND = IBEG + NX1 - 1;
+  JBEG = ng[JDIR]; JEND = JBEG + NX2 - 1;
+  KBEG = ng[KDIR]; KEND = KBEG + NX3 - 1;
+  NMAX_POINT = MAX(NX1_TOT, MAX(NX2_TOT, NX3_TOT));
+
+  memset (grid, 0, sizeof(Grid));
+  for (dir = 0; dir < 3; dir++){
+    grid->x[dir]       = ARRAY_1D(tot[dir] + 1, double);
+    grid->xl[dir]      = ARRAY_1D(tot[dir] + 1, double);
+    grid->xr[dir]      = ARRAY_1D(tot[dir] + 1, double);
+    grid->dx[dir]      = ARRAY_1D(tot[dir] + 1, double);
+    grid->inv_dx[dir]  = ARRAY_1D(tot[dir] + 1, double);
+    grid->inv_dxi[dir] = ARRAY_1D(tot[dir] + 1, double);
+    dx = L[dir]/nx[dir];
+    for (i = 0; i <= tot[dir]; i++){
+      grid->xl[dir][i]      = (i - ng[dir])*dx;
+      grid->xr[dir][i]      = (i - ng[dir] + 1)*dx;
+      grid->x[dir][i]       = (i - ng[dir] + 0.5)*dx;
+      grid->dx[dir][i]      = dx;
+      grid->inv_dx[dir][i]  = 1.0/dx;
+      grid->inv_dxi[dir][i] = 1.0/dx;
+    }
+    grid->np_int[dir] = grid->np_int_glob[dir] = nx[dir];
+    grid->np_tot[dir] = tot[dir];
+    grid->nghost[dir] = ng[dir];
+    grid->beg[dir]  = grid->lbeg[dir] = grid->gbeg[dir] = ng[dir];
+    grid->end[dir]  = grid->lend[dir] = grid->gend[dir] = ng[dir] + nx[dir] - 1;
+    grid->lbound[dir] = grid->rbound[dir] = PERIODIC;
+    grid->nproc[dir]  = 1;
+    grid->xbeg_glob[dir] = 0.0;
+    grid->xend_glob[dir] = L[dir];
+    runtime.left_bound[dir] = runtime.right_bound[dir] = PERIODIC;
+  }
+  grid->dV = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+  TOT_LOOP(k,j,i){
+    grid->dV[k][j][i] = grid->dx[IDIR][i]*grid->dx[JDIR][j]*grid->dx[KDIR][k];
+  }
+
+  runtime.log_freq = 1;
+  runtime.cfl      = 0.8;
+  runtime.cfl_par  = 0.8/DIMENSIONS;
+  sprintf (runtime.output_dir, ".");
+  sprintf (runtime.log_dir, ".");
+
+  d->Vc   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  d->Uc   = ARRAY_4D(NX3_TOT, NX2_TOT, NX1_TOT, NVAR, double);
+  d->flag = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, unsigned char);
+  #if THERMAL_CONDUCTION
+  d->Tc   = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+  #endif
+  InitDomain (d, grid);
+  for (nv = TRC + 1; nv < TRC + NTRACER; nv++){
+    TOT_LOOP(k,j,i) d->Vc[nv][k][j][i] = d->Vc[TRC][k][j][i];
+  }
+  Boundary (d, ALL_DIR, grid);
+}
+
+/* ********************************************************************* */
+void Boundary (const Data *d, int idir, Grid *grid)
+/*!
+ * Periodic boundaries in all directions.
+ *********************************************************************** */
+{
+  int nv, i, j, k, g;
+
+  for (nv = 0; nv < NVAR; nv++){
+    for (k = KBEG; k <= KEND; k++) for (j = JBEG; j <= JEND; j++){
+      for (g = 0; g < IBEG; g++){
+        d->Vc[nv][k][j][g]          = d->Vc[nv][k][j][g + NX1];
+        d->Vc[nv][k][j][IEND+1+g]   = d->Vc[nv][k][j][IBEG + g];
+      }
+    }
+    for (k = KBEG; k <= KEND; k++) for (g = 0; g < JBEG; g++) ITOT_LOOP(i){
+      d->Vc[nv][k][g][i]            = d->Vc[nv][k][g + NX2][i];
+      d->Vc[nv][k][JEND+1+g][i]     = d->Vc[nv][k][JBEG + g][i];
+    }
+    for (g = 0; g < KBEG; g++) JTOT_LOOP(j) ITOT_LOOP(i){
+      d->Vc[nv][g][j][i]            = d->Vc[nv][g + NX3][j][i];
+      d->Vc[nv][KEND+1+g][j][i]     = d->Vc[nv][KBEG + g][j][i];
+    }
+  }
+}
+
+/* ********************************************************************* */
+double *GetInverse_dl (const Grid *grid)
+/*!
+ * Inverse line element along g_dir (Cartesian).
+ *********************************************************************** */
+{
+  return grid->inv_dx[g_dir];
+}
+
+/* -- Core operators not available here -- */
+
+void TC_RHS (const Data *d, Data_Arr dU, double *dcoeff, double **aflux,
+             double dt, int beg, int end, Grid *grid)
+{ BenchDiffusionOnly ("TC_RHS"); }
+
+void ViscousRHS (const Data *d, Data_Arr dU, double *dcoeff, double **aflux,
+                 double dt, int beg, int end, Grid *grid)
+{ BenchDiffusionOnly ("ViscousRHS"); }
+
+void ResistiveRHS (const Data *d, Data_Arr dU, double **dcoeff,
+                   double **aflux, double dt, int beg, int end, Grid *grid)
+{ BenchDiffusionOnly ("ResistiveRHS"); }
+
+void GetCurrent (const Data *d, Grid *grid) {}
+
+void StoreAMRFlux (double **flux, double **aflux, int s, int beg, int end,
+                   int l, int r, Grid *grid) {}
+
+/* ********************************************************************* */
+static void BenchDiffusionOnly (const char *name)
+/*!
+ * Stop when a core operator is called.
+ *********************************************************************** */
+{
+  printLog ("! %s() is not part of the standalone benchmark:\n", name);
+  printLog ("  set PARABOLIC_FUSED to YES in definitions.h\n");
+  QUIT_PLUTO(1);
+}
+
+/* ********************************************************************* */
+int ParamFileRead (const char *fname)
+/*!
+ * Keep the lines of the parameter file fname.
+ *********************************************************************** */
+{
+  char  line[512];
+  FILE *fp = fopen(fname, "r");
+
+  if (fp == NULL){
+    printLog ("! ParamFileRead(): cannot open %s\n", fname);
+    QUIT_PLUTO(1);
+  }
+  while (ini_nlines < BENCH_MAX_LINES && fgets(line, sizeof(line), fp)){
+    ini_line[ini_nlines] = (char *) malloc(strlen(line) + 1);
+    strcpy (ini_line[ini_nlines++], line);
+  }
+  fclose (fp);
+  return 0;
+}
+
+/* ********************************************************************* */
+char *ParamFileGet (const char *label, int pos)
+/*!
+ * Return field pos (0 = label) of the line starting with label;
+ * abort if it does not exist, as PLUTO does.
+ *********************************************************************** */
+{
+  static char field[8][128];
+  static int  nf;
+  char   line[512], *t;
+  int    n, m;
+
+  for (n = 0; n < ini_nlines; n++){
+    strcpy (line, ini_line[n]);
+    t = strtok (line, " \t\r\n");
+    if (t == NULL || strcmp(t, label) != 0) continue;
+    for (m = 1; m <= pos && t != NULL; m++) t = strtok (NULL, " \t\r\n");
+    if (t == NULL) break;
+    nf = (nf + 1)%8;
+    strcpy (field[nf], t);
+    return field[nf];
+  }
+  printLog ("! ParamFileGet(): field # %d of '%s' does not exist\n", pos, label);
+  QUIT_PLUTO(1);
+  return NULL;
+}
+
+/* ********************************************************************* */
+int ParamExist (const char *label)
+{
+  char line[512], *t;
+  int  n;
+
+  for (n = 0; n < ini_nlines; n++){
+    strcpy (line, ini_line[n]);
+    t = strtok (line, " \t\r\n");
+    if (t != NULL && strcmp(t, label) == 0) return 1;
+  }
+  return 0;
+}
+
+/* ********************************************************************* */
+int ParamFileHasBoth (const char *label, const char *sval)
+{
+  char line[512], *t;
+  int  n;
+
+  for (n = 0; n < ini_nlines; n++){
+    strcpy (line, ini_line[n]);
+    t = strtok (line, " \t\r\n");
+    if (t == NULL || strcmp(t, label) != 0) continue;
+    while ((t = strtok (NULL, " \t\r\n")) != NULL){
+      if (strcmp(t, sval) == 0) return 1;
+    }
+  }
+  return 0;
+}
+
+/* -- Arrays, output and runtime -- */
+
+void *Array1D (int n, size_t sz)
+{
+  void *p = calloc((size_t)n, sz);
+
+  if (p == NULL){
+    printLog ("! Array1D(): out of memory\n");
+    QUIT_PLUTO(1);
+  }
+  return p;
+}
+
+void **Array2D (int n, int m, size_t sz)
+{
+  int   i;
+  char **p = (char **) Array1D(n, sizeof(char *));
+
+  p[0] = (char *) Array1D(n*m, sz);
+  for (i = 1; i < n; i++) p[i] = p[0] + (size_t)i*m*sz;
+  return (void **) p;
+}
+
+void ***Array3D (int n, int m, int l, size_t sz)
+{
+  int    i, j;
+  char ***p = (char ***) Array1D(n, sizeof(char **));
+
+  p[0]    = (char **) Array1D(n*m, sizeof(char *));
+  p[0][0] = (char *)  Array1D(n*m*l, sz);
+  for (i = 0; i < n; i++){
+    p[i] = p[0] + (size_t)i*m;
+    for (j = 0; j < m; j++) p[i][j] = p[0][0] + ((size_t)i*m + j)*l*sz;
+  }
+  return (void ***) p;
+}
+
+void ****Array4D (int n, int m, int l, int q, size_t sz)
+{
+  int     i, j, k;
+  char ****p = (char ****) Array1D(n, sizeof(char ***));
+
+  p[0]       = (char ***) Array1D(n*m, sizeof(char **));
+  p[0][0]    = (char **)  Array1D(n*m*l, sizeof(char *));
+  p[0][0][0] = (char *)   Array1D(n*m*l*q, sz);
+  for (i = 0; i < n; i++){
+    p[i] = p[0] + (size_t)i*m;
+    for (j = 0; j < m; j++){
+      p[i][j] = p[0][0] + ((size_t)i*m + j)*l;
+      for (k = 0; k < l; k++){
+        p[i][j][k] = p[0][0][0] + (((size_t)i*m + j)*l + k)*q*sz;
+      }
+    }
+  }
+  return (void ****) p;
+}
+
+void FreeArray1D (void *p)    {free (p);}
+void FreeArray2D (void **p)   {free (p[0]); free (p);}
+void FreeArray3D (void ***p)  {free (p[0][0]); free (p[0]); free (p);}
+void FreeArray4D (void ****p) {free (p[0][0][0]); free (p[0][0]); free (p[0]); free (p);}
+
+void print (const char *fmt, ...)
+{
+  va_list args;
+  va_start (args, fmt);
+  vprintf (fmt, args);
+  va_end (args);
+}
+
+void printLog (const char *fmt, ...)
+{
+  va_list args;
+  va_start (args, fmt);
+  vprintf (fmt, args);
+  va_end (args);
+}
+
+void QUIT_PLUTO (int status)
+{
+  exit (status);
+}
+
+Runtime *RuntimeGet (void)
+{
+  return &runtime;
+}
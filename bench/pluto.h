@@ -0,0 +1,237 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Minimal stand-in for the PLUTO headers (standalone benchmark).
+
+  Declares the subset of PLUTO 4.4 constants, macros, structures and
+  functions used by the setup sources, so that the parabolic kernels
+  can be compiled and timed outside PLUTO (see bench_main.c).
+  Only the serial, uniform Cartesian HD configuration is covered.
+  Values of the compile-time switches come from ../definitions.h;
+  the number of tracers can be overridden with -DBENCH_NTRACER=<n>.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#ifndef PLUTO_H
+#define PLUTO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define YES  1
+#define NO   0
+
+#define HD   1
+#define MHD  3
+
+#define CARTESIAN    1
+#define CYLINDRICAL  2
+#define POLAR        3
+#define SPHERICAL    4
+
+#define EXPLICIT             1
+#define SUPER_TIME_STEPPING  2
+#define RK_LEGENDRE          3
+
+#define RK3       3
+#define WENO3     5
+#define IDEAL     1
+#define PERIODIC  4
+
+#define CENTER  0
+#define X1FACE  1
+#define X2FACE  2
+#define X3FACE  3
+#define X1_BEG  1
+#define X1_END  2
+#define X2_BEG  3
+#define X2_END  4
+#define X3_BEG  5
+#define X3_END  6
+
+#define IDIR     0
+#define JDIR     1
+#define KDIR     2
+#define ALL_DIR  -1
+
+#define CONST_PI  3.14159265358979
+#define CONST_mp  1.67262171e-24
+#define CONST_kB  1.3806505e-16
+
+#define FLAG_ENTROPY            1
+#define FLAG_INTERNAL_BOUNDARY  2
+
+#include "definitions.h"
+
+#ifdef BENCH_NTRACER
+  #undef  NTRACER
+  #define NTRACER  BENCH_NTRACER
+#endif
+
+#if PHYSICS != HD || GEOMETRY != CARTESIAN
+  #error The standalone benchmark covers HD in Cartesian geometry only
+#endif
+
+#ifndef RESISTIVITY
+  #define RESISTIVITY  NO
+#endif
+#ifndef AMBIPOLAR_DIFFUSION
+  #define AMBIPOLAR_DIFFUSION  NO
+#endif
+#ifndef HALL_MHD
+  #define HALL_MHD  NO
+#endif
+#ifndef INTERNAL_BOUNDARY
+  #define INTERNAL_BOUNDARY  NO
+#endif
+
+#define HAVE_ENERGY   1
+#define COMPONENTS    3
+#define INCLUDE_IDIR  1
+#define INCLUDE_JDIR  (DIMENSIONS >= 2)
+#define INCLUDE_KDIR  (DIMENSIONS == 3)
+
+#define PARABOLIC_FLUX  (THERMAL_CONDUCTION | VISCOSITY | RESISTIVITY)
+
+/* -- Variable labels -- */
+
+enum {RHO, MX1, MX2, MX3, ENG, NFLX};
+
+#define VX1   MX1
+#define VX2   MX2
+#define VX3   MX3
+#define PRS   ENG
+#define TRC   NFLX
+#define NVAR  (NFLX + NTRACER)
+#define ENTR  (NVAR)
+
+/* -- Macros -- */
+
+#define MAX(a,b)  ((a) >= (b) ? (a) : (b))
+#define MIN(a,b)  ((a) <= (b) ? (a) : (b))
+
+#if DIMENSIONS == 1
+  #define DIM_EXPAND(a,b,c)  a
+#elif DIMENSIONS == 2
+  #define DIM_EXPAND(a,b,c)  a b
+#else
+  #define DIM_EXPAND(a,b,c)  a b c
+#endif
+#define DIM_LOOP(d)  for ((d) = 0; (d) < DIMENSIONS; (d)++)
+
+#define ITOT_LOOP(i)  for ((i) = 0; (i) < NX1_TOT; (i)++)
+#define JTOT_LOOP(j)  for ((j) = 0; (j) < NX2_TOT; (j)++)
+#define KTOT_LOOP(k)  for ((k) = 0; (k) < NX3_TOT; (k)++)
+#define IDOM_LOOP(i)  for ((i) = IBEG; (i) <= IEND; (i)++)
+#define JDOM_LOOP(j)  for ((j) = JBEG; (j) <= JEND; (j)++)
+#define KDOM_LOOP(k)  for ((k) = KBEG; (k) <= KEND; (k)++)
+#define TOT_LOOP(k,j,i)  KTOT_LOOP(k) JTOT_LOOP(j) ITOT_LOOP(i)
+#define DOM_LOOP(k,j,i)  KDOM_LOOP(k) JDOM_LOOP(j) IDOM_LOOP(i)
+
+#define NVAR_LOOP(n)     for ((n) = NVAR; (n)--; )
+#define NTRACER_LOOP(n)  for ((n) = TRC; (n) < (TRC + NTRACER); (n)++)
+
+#define IBOX_LOOP(B,i)  for ((i) = (B)->ibeg; (i) <= (B)->iend; (i)++)
+#define JBOX_LOOP(B,j)  for ((j) = (B)->jbeg; (j) <= (B)->jend; (j)++)
+#define KBOX_LOOP(B,k)  for ((k) = (B)->kbeg; (k) <= (B)->kend; (k)++)
+#define BOX_LOOP(B,k,j,i)  KBOX_LOOP(B,k) JBOX_LOOP(B,j) IBOX_LOOP(B,i)
+
+#define ARRAY_1D(n,t)        (t *)    Array1D(n, sizeof(t))
+#define ARRAY_2D(n,m,t)      (t **)   Array2D(n, m, sizeof(t))
+#define ARRAY_3D(n,m,l,t)    (t ***)  Array3D(n, m, l, sizeof(t))
+#define ARRAY_4D(n,m,l,s,t)  (t ****) Array4D(n, m, l, s, sizeof(t))
+
+/* -- Structures -- */
+
+typedef double ****Data_Arr;
+
+typedef struct RBox_ {
+  int ibeg, iend, jbeg, jend, kbeg, kend, vpos;
+} RBox;
+
+typedef struct Data_ {
+  double ****Vc, ****Uc, ***Tc;
+  unsigned char ***flag;
+} Data;
+
+typedef struct Grid_ {
+  double *x[3], *xr[3], *xl[3], *dx[3], *inv_dx[3], *inv_dxi[3];
+  double ***dV, ***A[3];
+  double xbeg_glob[3], xend_glob[3];
+  int    np_int[3], np_tot[3], np_int_glob[3], nghost[3];
+  int    beg[3], end[3], lbeg[3], lend[3], gbeg[3], gend[3];
+  int    lbound[3], rbound[3], nproc[3], rank_coord[3];
+} Grid;
+
+typedef struct timeStep_ {
+  double invDt_hyp, invDt_par, cfl, cfl_par, rmax_par;
+  int    Nsts, Nrkl;
+} timeStep;
+
+typedef struct Runtime_ {
+  int    log_freq;
+  int    left_bound[3], right_bound[3];
+  double cfl, cfl_par, tstop, anl_dt;
+  char   output_dir[256], log_dir[256];
+} Runtime;
+
+typedef struct Output_ {
+  int type;
+} Output;
+
+/* -- Globals -- */
+
+extern int    IBEG, IEND, JBEG, JEND, KBEG, KEND;
+extern int    NX1, NX2, NX3, NX1_TOT, NX2_TOT, NX3_TOT;
+extern int    NX1_MAX, NX2_MAX, NX3_MAX, NMAX_POINT;
+extern int    g_dir, g_i, g_j, g_k, g_intStage, prank;
+extern long   g_stepNumber;
+extern double g_time, g_dt, g_gamma, g_inputParam[32];
+
+/* -- Functions (bench_main.c) -- */
+
+void   *Array1D (int, size_t);
+void  **Array2D (int, int, size_t);
+void ***Array3D (int, int, int, size_t);
+void ****Array4D (int, int, int, int, size_t);
+void   FreeArray1D (void *);
+void   FreeArray2D (void **);
+void   FreeArray3D (void ***);
+void   FreeArray4D (void ****);
+
+void   print (const char *, ...);
+void   printLog (const char *, ...);
+void   QUIT_PLUTO (int);
+Runtime *RuntimeGet (void);
+
+int    ParamFileRead (const char *);
+char  *ParamFileGet (const char *, int);
+int    ParamExist (const char *);
+int    ParamFileHasBoth (const char *, const char *);
+
+void   Boundary (const Data *, int, Grid *);
+double *GetInverse_dl (const Grid *);
+void   TC_RHS (const Data *, Data_Arr, double *, double **, double, int, int,
+               Grid *);
+void   ViscousRHS (const Data *, Data_Arr, double *, double **, double, int,
+                   int, Grid *);
+void   ResistiveRHS (const Data *, Data_Arr, double **, double **, double,
+                     int, int, Grid *);
+void   GetCurrent (const Data *, Grid *);
+void   StoreAMRFlux (double **, double **, int, int, int, int, int, Grid *);
+
+double ParabolicRHS (const Data *, Data_Arr, RBox *, double **, int, double,
+                     Grid *);
+void   ParabolicUpdate (const Data *, Data_Arr, RBox *, double **, double,
+                        timeStep *, Grid *);
+void   Visc_nu (double *, double, double, double, double *, double *);
+void   TC_kappa (double *, double, double, double, double *, double *,
+                 double *);
+void   Init (double *, double, double, double);
+void   InitDomain (Data *, Grid *);
+
+#endif /* PLUTO_H */
@@ -7,7 +7,7 @@
 #define  TIME_STEPPING                  RK3
 #define  NTRACER                        1
 #define  PARTICLES                      NO
-#define  USER_DEF_PARAMETERS            11
+#define  USER_DEF_PARAMETERS            12
 
 /* -- physics dependent declarations -- */
 
@@ -31,6 +31,7 @@
 #define  RHO0                           8
 #define  PRS0                           9
 #define  LENGTH                         10
+#define  DIFFUSION                      11
 
 /* [Beg] user-defined constants (do not change this line) */
 
@@ -38,5 +39,11 @@
 #define  UNIT_DENSITY                   (g_inputParam[RHO0])
 #define  UNIT_VELOCITY                  (g_inputParam[U_FLOW])
 #define  MULTIPLE_LOG_FILES             YES
+#define  PARABOLIC_FUSED                YES
+#define  PARABOLIC_DT_STREAM            YES
+#define  PARABOLIC_RHS_STREAM           YES
+#define  TRACER_DIFFUSION               EXPLICIT
+#define  TRACER_ACTIVE_MASK             YES
+#define  TRACER_UNIFORM_GRID            YES
 
 /* [End] user-defined constants (do not change this line) */
@@ -0,0 +1,95 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Diffusion constants derived from the user parameters.
+
+  The viscous, conductive and tracer diffusivities of this problem
+  depend only on the parameters ::U_FLOW, ::LENGTH and ::REYNOLDS,
+  through \f$\chi = 2U L/{\rm Re}\f$ (CGS).
+  They are converted to code units once and kept in a
+  DiffusionConstants structure that every diffusion kernel
+  (Visc_nu(), TC_kappa(), the tracer and fused pencil kernels and the
+  spectral solver) reads through DiffusionConstantsGet().
+
+  The ::DIFFUSION parameter switches all of them (viscosity, thermal
+  conduction and tracer diffusion) on (1) or off (0) at runtime:
+  when off, ParabolicUpdate() returns at once and ParabolicRHS()
+  excludes these operators.
+
+  DiffusionConstantsUpdate() is called by ParabolicUpdate() and
+  ParabolicRHS() before any kernel runs, and rebuilds the structure
+  the first time and whenever one of the parameters has changed since
+  the last build (e.g. after a restart or a change of g_inputParam at
+  runtime).
+
+  The flag \c trc_const marks tracer diffusivities that do not depend
+  on position, so that ParabolicRHS() can obtain their inverse time
+  step from the grid spacing alone.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+static DiffusionConstants dconst;
+static int built = 0;
+
+/* ********************************************************************* */
+int DiffusionConstantsUpdate (void)
+/*!
+ * Rebuild the diffusion constants if the parameters they depend on
+ * have changed. Must be called outside parallel regions.
+ *
+ * \return 1 if the constants have been rebuilt, 0 otherwise.
+ *********************************************************************** */
+{
+  int    n;
+  double mu = 0.5;
+  double par[4], del_u, chi;
+
+  par[0] = g_inputParam[U_FLOW];
+  par[1] = g_inputParam[LENGTH];
+  par[2] = g_inputParam[REYNOLDS];
+  par[3] = g_inputParam[DIFFUSION];
+  if (   built && par[0] == dconst.par[0] && par[1] == dconst.par[1]
+      && par[2] == dconst.par[2] && par[3] == dconst.par[3]) return 0;
+
+  dconst.on = (par[3] != 0.0);
+
+  del_u = 2*par[0];   // CGS
+  chi   = par[1]*del_u/par[2];
+
+/* -- Viscosity: nu1 = rho*nu_visc -- */
+
+  dconst.nu_visc = chi/(UNIT_LENGTH*UNIT_VELOCITY);
+
+/* -- Conduction: kpar = n kB chi = rho*kappa_tc in code units -- */
+
+  dconst.kappa_tc = (UNIT_DENSITY/(CONST_mp*mu))*CONST_kB*chi
+                    *CONST_mp*mu/(UNIT_DENSITY*UNIT_VELOCITY*UNIT_LENGTH*CONST_kB);
+  dconst.phi_tc   = 0.3;
+
+/* -- Tracers: flux = rho*nu_trc*grad(C) -- */
+
+  for (n = 0; n < NTRACER; n++) dconst.nu_trc[n] = chi/(UNIT_LENGTH*UNIT_VELOCITY);
+  dconst.trc_const = 1;
+
+  dconst.par[0] = par[0];
+  dconst.par[1] = par[1];
+  dconst.par[2] = par[2];
+  dconst.par[3] = par[3];
+  built = 1;
+  return 1;
+}
+
+/* ********************************************************************* */
+const DiffusionConstants *DiffusionConstantsGet (void)
+/*!
+ * Return a pointer to the current diffusion constants, building them
+ * at the first call.
+ *********************************************************************** */
+{
+  if (!built) DiffusionConstantsUpdate ();
+  return &dconst;
+}
@@ -0,0 +1,188 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Minimal radix-2 fast Fourier transform.
+
+  Provides in-place complex transforms and real-to-complex /
+  complex-to-real transforms of power-of-two length, used by the
+  spectral diffusion stage (spectral_diffusion.c).
+  Complex arrays are stored interleaved, <tt>z[2m] = Re, z[2m+1] = Im</tt>.
+  All transforms are unnormalized:
+  \f[
+     Z_k = \sum_{m=0}^{n-1} z_m e^{\mp 2\pi i km/n}
+  \f]
+  with the minus sign for forward (\c sign = -1) transforms, so that a
+  forward-inverse pair multiplies the data by \c n.
+
+  A plan only holds read-only tables and can be shared among threads.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+/* ********************************************************************* */
+FFTPlan *FFT_CreatePlan (int n, int real)
+/*!
+ * Create the tables needed by a transform of length n.
+ *
+ * \param [in] n     the transform length (a power of 2)
+ * \param [in] real  when != 0, create a plan for real transforms
+ *                   of n points (FFT_RealForward(), FFT_RealInverse())
+ *
+ * \return A pointer to the newly allocated plan.
+ *********************************************************************** */
+{
+  int m, b, r, nb;
+  FFTPlan *plan;
+
+  if (n < 1 || (n & (n - 1)) != 0 || (real && n < 2)){
+    printLog ("! FFT_CreatePlan(): n = %d is not a power of 2\n", n);
+    QUIT_PLUTO(1);
+  }
+
+  plan = (FFTPlan *) malloc(sizeof(FFTPlan));
+  plan->n    = n;
+  plan->half = NULL;
+  plan->rev  = ARRAY_1D(n, int);
+  plan->wr   = ARRAY_1D(n/2 + 1, double);
+  plan->wi   = ARRAY_1D(n/2 + 1, double);
+
+  for (nb = 0; (1 << nb) < n; nb++);
+  for (m = 0; m < n; m++){
+    for (b = r = 0; b < nb; b++) r |= ((m >> b) & 1) << (nb - 1 - b);
+    plan->rev[m] = r;
+  }
+  for (m = 0; m <= n/2; m++){
+    plan->wr[m] =  cos(2.0*CONST_PI*m/n);
+    plan->wi[m] = -sin(2.0*CONST_PI*m/n);
+  }
+
+  if (real) plan->half = FFT_CreatePlan (n/2, 0);
+  return plan;
+}
+
+/* ********************************************************************* */
+void FFT_Complex (FFTPlan *plan, double *z, int sign)
+/*!
+ * In-place complex transform of plan->n points.
+ *
+ * \param [in]     plan   a complex plan
+ * \param [in,out] z      interleaved complex data
+ * \param [in]     sign   -1 for forward, +1 for inverse transforms
+ *********************************************************************** */
+{
+  int    n = plan->n, m, r, len, h, s, a, b;
+  double tr, ti, wr, wi;
+
+  for (m = 0; m < n; m++){
+    r = plan->rev[m];
+    if (r > m){
+      tr = z[2*m]; z[2*m] = z[2*r]; z[2*r] = tr;
+      ti = z[2*m+1]; z[2*m+1] = z[2*r+1]; z[2*r+1] = ti;
+    }
+  }
+
+  for (len = 2; len <= n; len <<= 1){
+    h = len/2;
+    s = n/len;                 /* Stride in the twiddle table */
+    for (a = 0; a < n; a += len){
+      for (m = 0; m < h; m++){
+        wr = plan->wr[m*s];
+        wi = -sign*plan->wi[m*s];  /* Table holds forward twiddles */
+        b  = a + m;
+        tr = wr*z[2*(b+h)]   - wi*z[2*(b+h)+1];
+        ti = wr*z[2*(b+h)+1] + wi*z[2*(b+h)];
+        z[2*(b+h)]   = z[2*b]   - tr;
+        z[2*(b+h)+1] = z[2*b+1] - ti;
+        z[2*b]      += tr;
+        z[2*b+1]    += ti;
+      }
+    }
+  }
+}
+
+/* ********************************************************************* */
+void FFT_RealForward (FFTPlan *plan, double *x, double *X)
+/*!
+ * Forward transform of plan->n real points.
+ * The n/2 + 1 non-redundant coefficients are returned in X; x is used
+ * as scratch and overwritten.
+ * The real sequence is packed into a complex one of n/2 points,
+ * z_m = x_{2m} + i x_{2m+1}, whose transform is then separated into
+ * the even and odd parts.
+ *
+ * \param [in]  plan   a real plan
+ * \param [in]  x      real data (n points)
+ * \param [out] X      interleaved complex coefficients (n/2 + 1 points)
+ *********************************************************************** */
+{
+  int    n = plan->n, h = n/2, m;
+  double *z = x;
+  double er, ei, or, oi, wr, wi;
+
+  FFT_Complex (plan->half, z, -1);
+
+  X[0] = z[0] + z[1]; X[1] = 0.0;
+  X[n] = z[0] - z[1]; X[n+1] = 0.0;
+  for (m = 1; m <= h/2; m++){
+    int q = h - m;
+
+  /* -- Fe = (Z_m + Z*_q)/2,  Fo = -i(Z_m - Z*_q)/2 -- */
+
+    er = 0.5*(z[2*m]   + z[2*q]);
+    ei = 0.5*(z[2*m+1] - z[2*q+1]);
+    or = 0.5*(z[2*m+1] + z[2*q+1]);
+    oi = 0.5*(z[2*q]   - z[2*m]);
+
+    wr = plan->wr[m]; wi = plan->wi[m];
+    X[2*m]   = er + wr*or - wi*oi;
+    X[2*m+1] = ei + wr*oi + wi*or;
+    X[2*q]   = er - wr*or + wi*oi;      /* X_q = conj(Fe_m - W^m Fo_m) */
+    X[2*q+1] = -(ei - wr*oi - wi*or);
+  }
+}
+
+/* ********************************************************************* */
+void FFT_RealInverse (FFTPlan *plan, double *X, double *x)
+/*!
+ * Inverse of FFT_RealForward(): from the n/2 + 1 coefficients X
+ * recover n real points, multiplied by n.
+ * X is used as scratch and overwritten.
+ *
+ * \param [in]  plan   a real plan
+ * \param [in]  X      interleaved complex coefficients (n/2 + 1 points)
+ * \param [out] x      real data (n points)
+ *********************************************************************** */
+{
+  int    n = plan->n, h = n/2, m;
+  double er, ei, or, oi, dr, di, wr, wi, ar, ai, br, bi;
+
+  for (m = 0; m <= h/2; m++){
+    int q = h - m;
+
+    ar = X[2*m]; ai = X[2*m+1];
+    br = X[2*q]; bi = X[2*q+1];
+
+  /* -- Fe = X_m + X*_q,  Fo = (X_m - X*_q) W^-m  (times 2) -- */
+
+    er = ar + br;
+    ei = ai - bi;
+    dr = ar - br;
+    di = ai + bi;
+    wr = plan->wr[m]; wi = -plan->wi[m];
+    or = dr*wr - di*wi;
+    oi = dr*wi + di*wr;
+
+  /* -- Z_m = Fe + i Fo, and Z_q from the conjugate-symmetric pair -- */
+
+    x[2*m]   = er - oi;
+    x[2*m+1] = ei + or;
+    if (q != m && q < h){
+      x[2*q]   = er + oi;
+      x[2*q+1] = -ei + or;
+    }
+  }
+  FFT_Complex (plan->half, x, +1);
+}
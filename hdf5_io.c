@@ -0,0 +1,353 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Compressed HDF5 output (dbl.h5 and flt.h5).
+
+  Local replacement of the core hdf5_io.c: the setup directory comes
+  first in the build, so this file is compiled in its place.
+  It compiles the core source unchanged (its path, \c PLUTO_HDF5_SRC,
+  is set in local_make) with dataset creation, write and close
+  redirected to the wrappers below, which add a per-variable filter
+  pipeline to the datasets of the output variables.
+
+  Filters are set by lines of pluto.ini:
+  \verbatim
+  h5_compress.<var>      <deflate>   <digits>
+  h5_compress.default    <deflate>   <digits>
+  h5_readback            <0|1>
+  \endverbatim
+  where \c var is the name given by OutputVarName(), \c deflate the
+  gzip level (0-9, preceded by byte shuffling, -1 for none) and
+  \c digits, when >= 0, enables the (lossy) HDF5 scale-offset filter
+  keeping that many decimal digits, i.e. an absolute error below
+  10^-digits (-1 for lossless output).
+  Lossy output is opt-in (the shipped pluto.ini is lossless) and only
+  applies to \c flt.h5 and asynchronous snapshots: \c dbl.h5 files are
+  restart checkpoints, so their \c digits are ignored (with a warning
+  in the log) and only the lossless deflate stage is used.
+  Variables without a line (and no default) are stored contiguous and
+  uncompressed.
+  Compressed datasets are chunked in blocks of ::H5_COMPRESS_CHUNK
+  rows; with MPI, filtered datasets require parallel HDF5 1.10.2 or
+  later (PLUTO writes them collectively).
+
+  Every output reports in the log its write time and compression
+  ratio. With \c h5_readback set to 1, every compressed dataset is
+  also read back right after being written (bypassing the chunk
+  cache, i.e. through the filters) and the maximum error per variable
+  is reported; this doubles the I/O and is meant for choosing the
+  settings.
+  The same settings are used by the asynchronous writer (async_h5.c).
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#ifdef USE_HDF5
+
+#include <time.h>
+#include <hdf5.h>
+#include "local_pluto.h"
+
+#ifndef PLUTO_HDF5_SRC
+  #error PLUTO_HDF5_SRC (path of the core hdf5_io.c) must be set in local_make
+#endif
+#ifdef H5_USE_16_API
+  #error Compressed .h5 output requires the HDF5 1.8 API (no H5_USE_16_API)
+#endif
+
+typedef struct H5CompressDset_{
+  hid_t id;            /* Open compressed dataset */
+  int   nv;            /* Variable index          */
+} H5CompressDset;
+
+static int    h5c_init, h5c_readback, h5c_restart;
+static int    deflate_level[NVAR], scale_digits[NVAR];
+static int    h5c_nopen;
+static H5CompressDset h5c_open[NVAR];
+static double h5c_raw, h5c_stored, h5c_err[NVAR];
+
+static int    H5CompressVar (const char *);
+static hid_t  H5CompressPlist (int, int, int, const hsize_t *);
+
+/* ********************************************************************* */
+void H5CompressInit (void)
+/*!
+ * Read the compression settings (h5_compress.* and h5_readback lines
+ * of pluto.ini) at the first call. Must be called by the main thread.
+ *********************************************************************** */
+{
+  int  nv, level = -1, digits = -1;
+  char label[64], vname[32];
+
+  if (h5c_init) return;
+  h5c_init = 1;
+
+  if (ParamExist ("h5_compress.default")){
+    level  = atoi(ParamFileGet("h5_compress.default", 1));
+    digits = atoi(ParamFileGet("h5_compress.default", 2));
+  }
+  for (nv = 0; nv < NVAR; nv++){
+    deflate_level[nv] = level;
+    scale_digits[nv]  = digits;
+    OutputVarName (nv, vname);
+    sprintf (label, "h5_compress.%s", vname);
+    if (ParamExist (label)){
+      deflate_level[nv] = atoi(ParamFileGet(label, 1));
+      scale_digits[nv]  = atoi(ParamFileGet(label, 2));
+    }
+  }
+  h5c_readback = ParamExist ("h5_readback") &&
+                 atoi(ParamFileGet("h5_readback", 1)) != 0;
+}
+
+/* ********************************************************************* */
+int H5CompressReadBack (void)
+/*!
+ * \return 1 when compressed datasets should be read back and checked.
+ *********************************************************************** */
+{
+  return h5c_readback;
+}
+
+/* ********************************************************************* */
+hid_t H5CompressDcpl (const char *name, int rank, const hsize_t *dims)
+/*!
+ * Build the dataset creation property list of the variable name.
+ *
+ * \param [in] name   the dataset (variable) name
+ * \param [in] rank   the number of dimensions of the dataset
+ * \param [in] dims   the dataset size, slowest index first
+ *
+ * \return A new property list (to be closed by the caller), or
+ *         H5P_DEFAULT when the variable is not compressed.
+ *********************************************************************** */
+{
+  int nv = H5CompressVar (name);
+
+  if (nv < 0) return H5P_DEFAULT;
+  return H5CompressPlist (nv, scale_digits[nv], rank, dims);
+}
+
+/* ********************************************************************* */
+static hid_t H5CompressPlist (int nv, int digits, int rank,
+                              const hsize_t *dims)
+/*!
+ * Build the dataset creation property list of variable nv with
+ * \c digits decimal digits (-1 for lossless).
+ *********************************************************************** */
+{
+  int     d;
+  hsize_t chunk[H5S_MAX_RANK];
+  hid_t   dcpl;
+
+  for (d = 0; d < rank; d++) chunk[d] = 1;
+  chunk[rank-1] = dims[rank-1];
+  if (rank > 1) chunk[rank-2] = MIN(dims[rank-2], H5_COMPRESS_CHUNK);
+
+  dcpl = H5Pcreate (H5P_DATASET_CREATE);
+  H5Pset_chunk (dcpl, rank, chunk);
+  if (digits >= 0){
+    H5Pset_scaleoffset (dcpl, H5Z_SO_FLOAT_DSCALE, digits);
+  }else if (deflate_level[nv] > 0){
+    H5Pset_shuffle (dcpl);
+  }
+  if (deflate_level[nv] > 0) H5Pset_deflate (dcpl, deflate_level[nv]);
+  return dcpl;
+}
+
+/* ********************************************************************* */
+static int H5CompressVar (const char *name)
+/*!
+ * Return the index of the variable with the given name when it has
+ * compression settings, or -1.
+ *********************************************************************** */
+{
+  int  nv;
+  char vname[32];
+
+  H5CompressInit ();
+  for (nv = 0; nv < NVAR; nv++){
+    OutputVarName (nv, vname);
+    if (strcmp(vname, name) == 0){
+      return (deflate_level[nv] >= 0 || scale_digits[nv] >= 0) ? nv : -1;
+    }
+  }
+  return -1;
+}
+
+/* ********************************************************************* */
+static hid_t H5CompressCreate (hid_t loc, const char *name, hid_t type,
+                               hid_t space, hid_t lcpl, hid_t dcpl,
+                               hid_t dapl)
+/*!
+ * H5Dcreate2() of the core output: datasets of compressed variables
+ * (created with default properties) get the filter pipeline.
+ *********************************************************************** */
+{
+  int     rank, nv = H5CompressVar (name);
+  hsize_t dims[H5S_MAX_RANK];
+  hid_t   dset, cdcpl, cdapl;
+
+  if (nv < 0 || dcpl != H5P_DEFAULT || h5c_nopen == NVAR){
+    return H5Dcreate2 (loc, name, type, space, lcpl, dcpl, dapl);
+  }
+
+  rank  = H5Sget_simple_extent_dims (space, dims, NULL);
+  cdcpl = H5CompressPlist (nv, h5c_restart ? -1 : scale_digits[nv],
+                           rank, dims);
+  cdapl = (dapl == H5P_DEFAULT ? H5Pcreate (H5P_DATASET_ACCESS)
+                               : H5Pcopy (dapl));
+
+/* -- No chunk cache: the read-back goes through the filters -- */
+
+  if (h5c_readback) H5Pset_chunk_cache (cdapl, 0, 0, 1.0);
+  dset = H5Dcreate2 (loc, name, type, space, lcpl, cdcpl, cdapl);
+  H5Pclose (cdapl);
+  H5Pclose (cdcpl);
+
+  if (dset >= 0){
+    h5c_open[h5c_nopen].id = dset;
+    h5c_open[h5c_nopen].nv = nv;
+    h5c_nopen++;
+  }
+  return dset;
+}
+
+/* ********************************************************************* */
+static herr_t H5CompressWrite (hid_t dset, hid_t mtype, hid_t mspace,
+                               hid_t fspace, hid_t xfer, const void *buf)
+/*!
+ * H5Dwrite() of the core output: with h5_readback, compressed datasets
+ * are read back with the same selections and compared with buf.
+ *********************************************************************** */
+{
+  int      n, nv = -1;
+  size_t   size;
+  hssize_t l, npt;
+  hid_t    space;
+  herr_t   status = H5Dwrite (dset, mtype, mspace, fspace, xfer, buf);
+  double   err = 0.0;
+  char     *check;
+
+  for (n = 0; n < h5c_nopen; n++) if (h5c_open[n].id == dset) nv = h5c_open[n].nv;
+  if (nv < 0 || !h5c_readback || status < 0) return status;
+
+/* -- Read into a copy of buf, so that zones outside the
+      memory selection (e.g. ghost zones) compare equal -- */
+
+  space = (mspace == H5S_ALL ? H5Dget_space (dset) : mspace);
+  npt   = H5Sget_simple_extent_npoints (space);
+  if (mspace == H5S_ALL) H5Sclose (space);
+  size  = H5Tget_size (mtype);
+  check = (char *) malloc (npt*size);
+  memcpy (check, buf, npt*size);
+  H5Dread (dset, mtype, mspace, fspace, xfer, check);
+  if (size == sizeof(float)){
+    const float *q = (const float *) buf, *c = (const float *) check;
+    for (l = 0; l < npt; l++) err = MAX(err, fabs((double)c[l] - (double)q[l]));
+  }else{
+    const double *q = (const double *) buf, *c = (const double *) check;
+    for (l = 0; l < npt; l++) err = MAX(err, fabs(c[l] - q[l]));
+  }
+  free (check);
+  h5c_err[nv] = MAX(h5c_err[nv], err);
+  return status;
+}
+
+/* ********************************************************************* */
+static herr_t H5CompressClose (hid_t dset)
+/*!
+ * H5Dclose() of the core output: add the raw and stored size of
+ * compressed datasets to the output totals.
+ *********************************************************************** */
+{
+  int   n;
+  hid_t space, type;
+
+  for (n = 0; n < h5c_nopen; n++){
+    if (h5c_open[n].id != dset) continue;
+    space = H5Dget_space (dset);
+    type  = H5Dget_type (dset);
+    h5c_raw    += (double)H5Sget_simple_extent_npoints (space)*H5Tget_size (type);
+    h5c_stored += (double)H5Dget_storage_size (dset);
+    H5Tclose (type);
+    H5Sclose (space);
+    h5c_open[n] = h5c_open[--h5c_nopen];
+    break;
+  }
+  return H5Dclose (dset);
+}
+
+/* --------------------------------------------------------
+   The core writer, with dataset creation, write and close
+   redirected to the functions above
+   -------------------------------------------------------- */
+
+#define H5Dcreate2  H5CompressCreate
+#define H5Dwrite    H5CompressWrite
+#define H5Dclose    H5CompressClose
+#define WriteHDF5   WriteHDF5Core
+
+#include PLUTO_HDF5_SRC
+
+#undef H5Dcreate2
+#undef H5Dwrite
+#undef H5Dclose
+#undef WriteHDF5
+
+/* ********************************************************************* */
+void WriteHDF5 (Output *output, Grid *grid)
+/*!
+ * Write an .h5 output with the core writer and report its write time,
+ * compression ratio and (with h5_readback) read-back errors.
+ *
+ * \param [in] output  the output structure
+ * \param [in] grid    pointer to Grid structure
+ *********************************************************************** */
+{
+  int    nv;
+  double t0;
+  char   vname[32];
+  struct timespec ts;
+  static int warned = 0;
+
+  H5CompressInit ();
+
+/* -- dbl.h5 is a restart file: never quantise it -- */
+
+  h5c_restart = (output->type == DBL_H5_OUTPUT);
+  for (nv = 0; nv < NVAR && h5c_restart && !warned; nv++){
+    if (scale_digits[nv] >= 0){
+      printLog ("! WriteHDF5(): h5_compress digits ignored in dbl.h5 ");
+      printLog ("(restart) output, written lossless\n");
+      warned = 1;
+    }
+  }
+
+  h5c_raw = h5c_stored = 0.0;
+  for (nv = 0; nv < NVAR; nv++) h5c_err[nv] = 0.0;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  t0 = ts.tv_sec + 1.e-9*ts.tv_nsec;
+  WriteHDF5Core (output, grid);
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  printLog ("> WriteHDF5(): %.3f s", ts.tv_sec + 1.e-9*ts.tv_nsec - t0);
+  if (h5c_raw > 0.0){
+    printLog (", compressed %.1f MB -> %.1f MB (ratio %.2f)", h5c_raw/1.e6,
+              h5c_stored/1.e6, h5c_raw/MAX(h5c_stored, 1.0));
+  }
+  printLog ("\n");
+  if (h5c_readback && h5c_raw > 0.0){
+    printLog ("  max read-back error:");
+    for (nv = 0; nv < NVAR; nv++){
+      OutputVarName (nv, vname);
+      if (H5CompressVar (vname) >= 0) printLog (" %s %.2e", vname, h5c_err[nv]);
+    }
+    printLog ("\n");
+  }
+}
+
+#endif /* USE_HDF5 */
@@ -12,6 +12,7 @@
 */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
+#include "local_pluto.h"
 
 /* ********************************************************************* */
 void Init (double *v, double x1, double x2, double x3)
@@ -51,16 +52,20 @@ void InitDomain (Data *d, Grid *grid)
  * on primitive variables.
  * Value assigned here will overwrite those prescribed during Init().
  *
+ * All profiles are separable: the y-dependent factors are tabulated
+ * once per row and the x-dependent one once per column, and the
+ * arrays are then filled in parallel. The result is bitwise identical
+ * to a direct zone-by-zone evaluation.
  *
  *********************************************************************** */
 {
-  int   i, j, k, nv;
-  double  *x, *y, *z;
+  int   i, j, k;
+  double  *x, *y;
+  double  *rho_y, *vx1_y, *vx2_y, *trc_y, *vx2_x;
   g_gamma = 5./3.;
 
   x = grid->x[IDIR];
   y = grid->x[JDIR];
-  z = grid->x[KDIR];
 
   double y1    = g_inputParam[Y1];
   double y2    = g_inputParam[Y2];
@@ -70,19 +75,61 @@ void InitDomain (Data *d, Grid *grid)
   double uflow = g_inputParam[U_FLOW];
   double P0    = g_inputParam[PRS0];
   double del_rho_by_rho0 = g_inputParam[DEL_RHO_BY_RHO0];
-  
-  TOT_LOOP(k,j,i){
-    d->Vc[RHO][k][j][i] = 1 + del_rho_by_rho0 * 
-                              0.5 * ( tanh((y[j]-y1)/a) - tanh((y[j]-y2)/a) );
-    d->Vc[PRS][k][j][i] = P0;
-    DIM_EXPAND(
-    d->Vc[VX1][k][j][i] = uflow * ( tanh((y[j]-y1)/a) - tanh((y[j]-y2)/a) - 1 );,
-    d->Vc[VX2][k][j][i] = amp * sin(2*CONST_PI*x[i]) * 
-                                ( exp(-pow((y[j]-y1)/sig,2)) + exp(-pow((y[j]-y2)/sig,2)) );,
-    d->Vc[VX3][k][j][i] = 0.;)
-    d->Vc[TRC][k][j][i] = 0.5 * ( tanh((y[j]-y2)/a) - tanh((y[j]-y1)/a) + 2 );  
+
+/* --------------------------------------------------------
+   1. Tabulate 1D profiles
+   -------------------------------------------------------- */
+
+  rho_y = ARRAY_1D(NX2_TOT, double);
+  vx1_y = ARRAY_1D(NX2_TOT, double);
+  vx2_y = ARRAY_1D(NX2_TOT, double);
+  trc_y = ARRAY_1D(NX2_TOT, double);
+  vx2_x = ARRAY_1D(NX1_TOT, double);
+
+  for (j = 0; j < NX2_TOT; j++){
+    double th1 = tanh((y[j]-y1)/a);
+    double th2 = tanh((y[j]-y2)/a);
+
+    rho_y[j] = 1 + del_rho_by_rho0 * 0.5 * ( th1 - th2 );
+    vx1_y[j] = uflow * ( th1 - th2 - 1 );
+    vx2_y[j] = exp(-pow((y[j]-y1)/sig,2)) + exp(-pow((y[j]-y2)/sig,2));
+    trc_y[j] = 0.5 * ( th2 - th1 + 2 );
   }
+  for (i = 0; i < NX1_TOT; i++) vx2_x[i] = amp * sin(2*CONST_PI*x[i]);
+
+/* --------------------------------------------------------
+   2. Fill the primitive arrays
+   -------------------------------------------------------- */
 
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) private(i)
+  #endif
+  for (k = 0; k < NX3_TOT; k++){
+  for (j = 0; j < NX2_TOT; j++){
+    double *rho = d->Vc[RHO][k][j];
+    double *prs = d->Vc[PRS][k][j];
+    double *trc = d->Vc[TRC][k][j];
+    DIM_EXPAND(
+    double *vx1 = d->Vc[VX1][k][j];  ,
+    double *vx2 = d->Vc[VX2][k][j];  ,
+    double *vx3 = d->Vc[VX3][k][j];)
+
+    for (i = 0; i < NX1_TOT; i++){
+      rho[i] = rho_y[j];
+      prs[i] = P0;
+      DIM_EXPAND(
+      vx1[i] = vx1_y[j];           ,
+      vx2[i] = vx2_x[i]*vx2_y[j];  ,
+      vx3[i] = 0.;)
+      trc[i] = trc_y[j];
+    }
+  }}
+
+  FreeArray1D ((void *) rho_y);
+  FreeArray1D ((void *) vx1_y);
+  FreeArray1D ((void *) vx2_y);
+  FreeArray1D ((void *) trc_y);
+  FreeArray1D ((void *) vx2_x);
 }
 
 /* ********************************************************************* */
@@ -90,12 +137,100 @@ void Analysis (const Data *d, Grid *grid)
 /*! 
  *  Perform runtime data analysis.
  *
+ *  Compute the Kelvin-Helmholtz diagnostics of Lecoanet et al. (2016)
+ *  as volume integrals over the local domain, summed over all ranks,
+ *  and append them to kh_diagnostics.dat in the output directory:
+ *
+ *  - the amplitude of the y-velocity mode,
+ *    \f$ M = 2\sqrt{(s/D)^2 + (c/D)^2}\f$ with
+ *    \f$ s = \int v_y\sin(2\pi x)\,w\,dV\f$,
+ *    \f$ c = \int v_y\cos(2\pi x)\,w\,dV\f$,
+ *    \f$ D = \int w\,dV\f$ and \f$ w = e^{-4\pi|y - y_i|}\f$,
+ *    where \f$y_i\f$ is the closest shear layer;
+ *  - the tracer "entropy" \f$ S = -\int\rho C\ln C\,dV\f$
+ *    (a measure of mixing);
+ *  - the kinetic energy in the x and y components,
+ *    \f$ \int\rho v_x^2/2\,dV\f$ and \f$ \int\rho v_y^2/2\,dV\f$.
+ *
+ *  The file is (re)created, with a header, at the first step of a run.
+ *  Horizontally averaged profiles (XAvgCheck()), shear-layer spectra
+ *  (KHSpectraCheck()) and, with ::ASYNC_H5, asynchronous snapshots
+ *  (AsyncH5Check()) are also taken here, and the parabolic kernel
+ *  benchmark (ParabolicBenchCheck()) is run at the first call.
+ *
  * \param [in] d the PLUTO Data structure
  * \param [in] grid   pointer to array of Grid structures  
  *
+ * \b References
+ *    - "A validated non-linear Kelvin-Helmholtz benchmark for numerical
+ *       hydrodynamics", Lecoanet et al., MNRAS (2016) 455, 4274
+ *
  *********************************************************************** */
 {
+  int    i, j, k;
+  double *x = grid->x[IDIR], *y = grid->x[JDIR];
+  double y1 = g_inputParam[Y1], y2 = g_inputParam[Y2];
+  double s = 0.0, c = 0.0, D = 0.0, S = 0.0, Ekx = 0.0, Eky = 0.0;
+  double sum[6], M;
+  char   fname[512];
+  FILE  *fp;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) private(i) \
+                           reduction(+:s,c,D,S,Ekx,Eky)
+  #endif
+  for (k = KBEG; k <= KEND; k++){
+  for (j = JBEG; j <= JEND; j++){
+    double w = exp(-4.0*CONST_PI*MIN(fabs(y[j] - y1), fabs(y[j] - y2)));
+
+    for (i = IBEG; i <= IEND; i++){
+      double dV  = grid->dV[k][j][i];
+      double rho = d->Vc[RHO][k][j][i];
+      double vx  = d->Vc[VX1][k][j][i];
+      double vy  = d->Vc[VX2][k][j][i];
+      double C   = d->Vc[TRC][k][j][i];
+
+      s   += vy*sin(2.0*CONST_PI*x[i])*w*dV;
+      c   += vy*cos(2.0*CONST_PI*x[i])*w*dV;
+      D   += w*dV;
+      if (C > 0.0) S -= rho*C*log(C)*dV;
+      Ekx += 0.5*rho*vx*vx*dV;
+      Eky += 0.5*rho*vy*vy*dV;
+    }
+  }}
+
+  sum[0] = s; sum[1] = c; sum[2] = D; sum[3] = S; sum[4] = Ekx; sum[5] = Eky;
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, sum, 6, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  #endif
+  M = 2.0*sqrt((sum[0]/sum[2])*(sum[0]/sum[2]) + (sum[1]/sum[2])*(sum[1]/sum[2]));
 
+  ParabolicBenchCheck (d, grid);
+  XAvgCheck (d, grid);
+  KHSpectraCheck (d, grid);
+  #if (ASYNC_H5 == YES) && defined(USE_HDF5)
+  AsyncH5Check (d, grid);
+  #endif
+
+  if (prank != 0) return;
+
+  sprintf (fname, "%s/kh_diagnostics.dat", RuntimeGet()->output_dir);
+  if (g_stepNumber == 0){
+    fp = fopen(fname, "w");
+    if (fp != NULL) {
+      fprintf (fp, "# %10s  %12s  %12s  %12s  %12s\n",
+                   "t", "M(vy)", "S(trc)", "KE_x", "KE_y");
+    }
+  }else{
+    fp = fopen(fname, "a");
+  }
+  if (fp == NULL){
+    printLog ("! Analysis(): cannot open %s\n", fname);
+    return;
+  }
+  fprintf (fp, "%12.6e  %12.6e  %12.6e  %12.6e  %12.6e\n",
+               g_time, M, sum[3], sum[4], sum[5]);
+  fclose (fp);
 }
 #if PHYSICS == MHD
 /* ********************************************************************* */
@@ -140,12 +275,7 @@ void UserDefBoundary (const Data *d, RBox *box, int side, Grid *grid)
  *
  *********************************************************************** */
 {
-  int   i, j, k, nv;
-  double  *x1, *x2, *x3;
-
-  x1 = grid->x[IDIR];
-  x2 = grid->x[JDIR];
-  x3 = grid->x[KDIR];
+  int   i, j, k;
 
   if (side == 0) {    /* -- check solution inside domain -- */
     DOM_LOOP(k,j,i){}
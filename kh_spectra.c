@@ -0,0 +1,216 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief In-situ x-spectra of velocity and tracer in the shear layers.
+
+  For every y row, the one-dimensional power spectra along the periodic
+  x direction of \f$v_x\f$, \f$v_y\f$ and of the tracer are computed
+  with the built-in FFT (fft.c) and averaged (dy-weighted) over the
+  rows within a distance \c h of each shear layer, \f$|y - y_i| < h\f$
+  with \f$y_i\f$ = ::Y1, ::Y2 (and over z in 3D).
+  Spectra are one-sided and normalized so that they sum, over
+  \f$m = 0..n_x/2\f$, to the x-average of \f$v_x^2/2\f$,
+  \f$v_y^2/2\f$ and \f$C^2\f$, respectively.
+
+  The output is configured by a line in the [Static Grid Output]
+  block of pluto.ini:
+  \verbatim
+  spectra   <dt>   <h>
+  \endverbatim
+  and spectra are computed by KHSpectraCheck(), called from
+  Analysis(), with output times rounded to the \c analysis interval.
+  Rank 0 appends them to the binary file \c spectra.bin in the output
+  directory (native endianness):
+  - header, written at the first step of a run:
+    <tt>int nk, int nlayer (= 2), int nfield (= 3),
+        double kx[nk]</tt>;
+  - one record per output:
+    <tt>double t, double E[nlayer][nfield][nk]</tt>, with fields
+    ordered as \f$v_x, v_y, C\f$.
+
+  The x direction must be periodic, not decomposed among processes,
+  uniform and with a power-of-two number of zones; layers may span
+  several processes in y and z.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#define SPEC_NFIELD  3
+#define SPEC_NLAYER  2
+
+/* ********************************************************************* */
+void KHSpectraCheck (const Data *d, Grid *grid)
+/*!
+ * Read the spectra line of pluto.ini at the first call, and write the
+ * spectra when a multiple of the output interval has been reached
+ * since the last output.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  static int    first = 1, last = -1;
+  static double dt_out = -1.0, h;
+  int n;
+
+  if (first){
+    first = 0;
+    if (!ParamExist ("spectra")) return;
+    dt_out = atof(ParamFileGet("spectra", 1));
+    h      = atof(ParamFileGet("spectra", 2));
+  }
+  if (dt_out <= 0.0) return;
+
+  n = (int)floor(g_time/dt_out + 1.e-9);
+  if (n <= last) return;
+  last = n;
+
+  KHSpectraWrite (d, h, grid);
+}
+
+/* ********************************************************************* */
+void KHSpectraWrite (const Data *d, double h, Grid *grid)
+/*!
+ * Compute and append one record of layer-averaged spectra.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] h      half width of the shear layers
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  static FFTPlan *plan;
+  static int     nx, nk;
+  int    m, size;
+  double y0[SPEC_NLAYER], *E, *Etot, W[SPEC_NLAYER], Wtot[SPEC_NLAYER];
+  char   fname[512];
+  FILE  *fp;
+
+/* --------------------------------------------------------
+   0. Check the x direction and create the plan (read-only,
+      shared among threads) at the first call
+   -------------------------------------------------------- */
+
+  if (plan == NULL){
+    double dx0 = grid->dx[IDIR][IBEG];
+
+    nx = grid->np_int_glob[IDIR];
+    if (grid->nproc[IDIR] != 1 || grid->lbound[IDIR] != PERIODIC
+                               || grid->rbound[IDIR] != PERIODIC){
+      printLog ("! KHSpectraWrite(): x must be periodic and not decomposed\n");
+      QUIT_PLUTO(1);
+    }
+    for (m = IBEG; m <= IEND; m++){
+      if (fabs(grid->dx[IDIR][m] - dx0) > 1.e-9*dx0){
+        printLog ("! KHSpectraWrite(): non-uniform grid in x\n");
+        QUIT_PLUTO(1);
+      }
+    }
+    plan = FFT_CreatePlan (nx, 1);
+    nk   = nx/2 + 1;
+  }
+
+  y0[0] = g_inputParam[Y1];
+  y0[1] = g_inputParam[Y2];
+  size  = SPEC_NLAYER*SPEC_NFIELD*nk;
+  E     = ARRAY_1D(size, double);
+  Etot  = ARRAY_1D(size, double);
+  for (m = 0; m < size; m++) E[m] = 0.0;
+  W[0] = W[1] = 0.0;
+
+/* --------------------------------------------------------
+   1. Row spectra, accumulated per thread and then summed
+   -------------------------------------------------------- */
+
+  #ifdef _OPENMP
+  #pragma omp parallel
+  #endif
+  {
+    int    i, j, k, l, f, mk, nv[SPEC_NFIELD] = {VX1, VX2, TRC};
+    double fac[SPEC_NFIELD] = {0.5, 0.5, 1.0};
+    double *x   = (double *) malloc(nx*sizeof(double));
+    double *X   = (double *) malloc((nx + 2)*sizeof(double));
+    double *acc = (double *) calloc(size, sizeof(double));
+    double wacc[SPEC_NLAYER] = {0.0, 0.0};
+
+    #ifdef _OPENMP
+    #pragma omp for collapse(2)
+    #endif
+    for (k = KBEG; k <= KEND; k++){
+    for (j = JBEG; j <= JEND; j++){
+      double y  = grid->x[JDIR][j];
+      double wy = grid->dx[JDIR][j]*grid->dx[KDIR][k];
+
+      for (l = 0; l < SPEC_NLAYER; l++){
+        if (fabs(y - y0[l]) >= h) continue;
+        wacc[l] += wy;
+        for (f = 0; f < SPEC_NFIELD; f++){
+          double *a = acc + (l*SPEC_NFIELD + f)*nk;
+          double norm = fac[f]*wy/((double)nx*nx);
+
+          for (i = IBEG; i <= IEND; i++) x[i - IBEG] = d->Vc[nv[f]][k][j][i];
+          FFT_RealForward (plan, x, X);
+          for (mk = 0; mk < nk; mk++){
+            double p = X[2*mk]*X[2*mk] + X[2*mk+1]*X[2*mk+1];
+            a[mk] += (mk == 0 || mk == nx/2 ? 1.0 : 2.0)*norm*p;
+          }
+        }
+      }
+    }}
+
+    #ifdef _OPENMP
+    #pragma omp critical
+    #endif
+    {
+      for (mk = 0; mk < size; mk++) E[mk] += acc[mk];
+      for (l = 0; l < SPEC_NLAYER; l++) W[l] += wacc[l];
+    }
+    free (x);
+    free (X);
+    free (acc);
+  }
+
+/* --------------------------------------------------------
+   2. Reduce across ranks; rank 0 normalizes and writes
+   -------------------------------------------------------- */
+
+  #ifdef PARALLEL
+  MPI_Reduce (E, Etot, size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce (W, Wtot, SPEC_NLAYER, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  #else
+  for (m = 0; m < size; m++) Etot[m] = E[m];
+  Wtot[0] = W[0]; Wtot[1] = W[1];
+  #endif
+
+  if (prank == 0){
+    for (m = 0; m < size; m++){
+      int l = m/(SPEC_NFIELD*nk);
+      Etot[m] = (Wtot[l] > 0.0 ? Etot[m]/Wtot[l] : 0.0);
+    }
+
+    sprintf (fname, "%s/spectra.bin", RuntimeGet()->output_dir);
+    fp = fopen(fname, g_stepNumber == 0 ? "wb" : "ab");
+    if (fp == NULL){
+      printLog ("! KHSpectraWrite(): cannot open %s\n", fname);
+    }else{
+      if (g_stepNumber == 0){
+        int    hdr[3] = {nk, SPEC_NLAYER, SPEC_NFIELD};
+        double L = grid->xend_glob[IDIR] - grid->xbeg_glob[IDIR], kx;
+
+        fwrite (hdr, sizeof(int), 3, fp);
+        for (m = 0; m < nk; m++){
+          kx = 2.0*CONST_PI*m/L;
+          fwrite (&kx, sizeof(double), 1, fp);
+        }
+      }
+      fwrite (&g_time, sizeof(double), 1, fp);
+      fwrite (Etot, sizeof(double), size, fp);
+      fclose (fp);
+    }
+  }
+
+  FreeArray1D ((void *) E);
+  FreeArray1D ((void *) Etot);
+}
@@ -1,5 +1,409 @@
-void   RHS_TRACER_Flux (double ****, const Sweep *, double **, int, int, Grid *);
-void   TRACER_RHS (const Data *, Data_Arr, double *,
+/* -- Fused tracer / viscosity / thermal conduction pencil kernel
+      (parabolic_fused.c). Set PARABOLIC_FUSED to YES in
+      definitions.h to enable it; it is used only for HD in
+      Cartesian coordinates with the ideal EOS. -- */
+
+#ifndef PARABOLIC_FUSED
+  #define PARABOLIC_FUSED  NO
+#endif
+
+#if (PARABOLIC_FUSED == YES) && (PHYSICS == HD) && \
+    (GEOMETRY == CARTESIAN) && (EOS == IDEAL) && !defined(CHOMBO)
+  #define PARABOLIC_FUSED_ON  YES
+#else
+  #define PARABOLIC_FUSED_ON  NO
+#endif
+
+/* -- Streaming reduction of the parabolic time step: the inverse
+      diffusion time of the tracer (and fused) operators is summed
+      across directions in tiles of PARABOLIC_TILE zones rather than
+      in full-grid arrays. Set PARABOLIC_DT_STREAM to YES in
+      definitions.h to enable it. -- */
+
+#ifndef PARABOLIC_DT_STREAM
+  #define PARABOLIC_DT_STREAM  NO
+#endif
+
+#ifndef PARABOLIC_TILE
+  #define PARABOLIC_TILE  8
+#endif
+
+/* -- Single-pass parabolic update: ParabolicRHS() accumulates the
+      pencil increments, scaled by dt, directly into the dU array of
+      the caller instead of a full-grid NVAR rhs buffer. Not
+      available with CTU schemes, which reuse the rhs of the previous
+      call (d == NULL), nor with the entropy switch, which needs the
+      rhs itself. Set PARABOLIC_RHS_STREAM to YES in definitions.h
+      to enable it. -- */
+
+#ifndef PARABOLIC_RHS_STREAM
+  #define PARABOLIC_RHS_STREAM  NO
+#endif
+
+#if    (PARABOLIC_RHS_STREAM == YES) && !defined(CTU) && !defined(CHOMBO) \
+    && !ENTROPY_SWITCH && (INTERNAL_BOUNDARY != YES)
+  #define PARABOLIC_RHS_STREAM_ON  YES
+#else
+  #define PARABOLIC_RHS_STREAM_ON  NO
+#endif
+
+#if (PARABOLIC_DT_STREAM == YES) && !defined(CHOMBO)
+  #define PARABOLIC_DT_STREAM_ON  YES
+#else
+  #define PARABOLIC_DT_STREAM_ON  NO
+#endif
+
+/* -- Time stepping of tracer diffusion: EXPLICIT, SUPER_TIME_STEPPING
+      or RK_LEGENDRE, as for the other diffusion operators, SPECTRAL
+      (exact FFT integration, fully periodic box only) or ADI
+      (implicit Crank-Nicolson, alternating directions; Cartesian
+      only). With STS, RKL, SPECTRAL or ADI, tracer diffusion is
+      operator-split: the increment over the full step is computed
+      at the beginning of the step (tracer_sts.c,
+      spectral_diffusion.c, tracer_adi.c) and added to each stage as
+      a constant rate, so it no longer limits the parabolic time
+      step. -- */
+
+#ifndef SPECTRAL
+  #define SPECTRAL  16
+#endif
+
+#ifndef ADI
+  #define ADI  17
+#endif
+
+#ifndef TRACER_DIFFUSION
+  #define TRACER_DIFFUSION  EXPLICIT
+#endif
+
+/* -- Spectral (operator-split) viscosity with constant kinematic
+      viscosity. Requires VISCOSITY to be NO. -- */
+
+#ifndef SPECTRAL_VISCOSITY
+  #define SPECTRAL_VISCOSITY  NO
+#endif
+
+#if (SPECTRAL_VISCOSITY == YES) && (VISCOSITY != NO)
+  #error SPECTRAL_VISCOSITY requires VISCOSITY to be NO
+#endif
+
+#if (TRACER_DIFFUSION == ADI) && (GEOMETRY != CARTESIAN)
+  #error TRACER_DIFFUSION == ADI requires Cartesian geometry
+#endif
+
+/* -- Implicit viscosity and thermal conduction (parabolic_mg.c):
+      operators declared EXPLICIT in definitions.h are advanced over
+      the full step at its beginning (theta-scheme, PARABOLIC_MG_THETA
+      = 1 is backward Euler, 0.5 Crank-Nicolson) by defect correction
+      with multigrid V-cycles, and no longer limit the time step;
+      operators declared SUPER_TIME_STEPPING or RK_LEGENDRE keep
+      their core integrator. HD, Cartesian and ideal EOS only. -- */
+
+#ifndef PARABOLIC_MG
+  #define PARABOLIC_MG  NO
+#endif
+
+#ifndef PARABOLIC_MG_THETA
+  #define PARABOLIC_MG_THETA  1.0
+#endif
+
+#ifndef PARABOLIC_MG_TOL
+  #define PARABOLIC_MG_TOL  1.e-8   /* Relative residual tolerance      */
+#endif
+
+#ifndef PARABOLIC_MG_MAXIT
+  #define PARABOLIC_MG_MAXIT  20    /* Max. defect correction iterations */
+#endif
+
+#ifndef PARABOLIC_MG_CYCLES
+  #define PARABOLIC_MG_CYCLES  1    /* V-cycles per correction           */
+#endif
+
+#if    (PARABOLIC_MG == YES) && !defined(CHOMBO) \
+    && ((VISCOSITY == EXPLICIT) || (THERMAL_CONDUCTION == EXPLICIT))
+  #if (PHYSICS != HD) || (GEOMETRY != CARTESIAN) || (EOS != IDEAL)
+    #error PARABOLIC_MG requires HD, Cartesian geometry and ideal EOS
+  #endif
+  #define PARABOLIC_MG_ON    YES
+  #define PARABOLIC_MG_VISC  (VISCOSITY == EXPLICIT)
+  #define PARABOLIC_MG_TC    (THERMAL_CONDUCTION == EXPLICIT)
+#else
+  #define PARABOLIC_MG_ON    NO
+  #define PARABOLIC_MG_VISC  0
+  #define PARABOLIC_MG_TC    0
+#endif
+
+#define PARABOLIC_MG_STEP  65   /* Pseudo time-stepping label used to
+                                   compute viscosity and conduction
+                                   alone */
+
+/* -- Explicit subcycling (parabolic_subcycle.c): the EXPLICIT
+      diffusion operators not solved by PARABOLIC_MG are advanced at
+      the beginning of the step by as many stable forward Euler
+      substeps as needed, so that the global time step follows the
+      hyperbolic CFL condition alone. HD, ideal EOS only. -- */
+
+#ifndef PARABOLIC_SUBCYCLE
+  #define PARABOLIC_SUBCYCLE  NO
+#endif
+
+#if (PARABOLIC_SUBCYCLE == YES) && !defined(CHOMBO)
+  #if (PHYSICS != HD) || (EOS != IDEAL)
+    #error PARABOLIC_SUBCYCLE requires HD and ideal EOS
+  #endif
+  #define PARABOLIC_SUB_VISC  ((VISCOSITY == EXPLICIT) && (PARABOLIC_MG_ON == NO))
+  #define PARABOLIC_SUB_TC    ((THERMAL_CONDUCTION == EXPLICIT) && (PARABOLIC_MG_ON == NO))
+  #define PARABOLIC_SUB_TRC   (TRACER_DIFFUSION == EXPLICIT)
+#else
+  #define PARABOLIC_SUB_VISC  0
+  #define PARABOLIC_SUB_TC    0
+  #define PARABOLIC_SUB_TRC   0
+#endif
+
+#if PARABOLIC_SUB_VISC || PARABOLIC_SUB_TC || PARABOLIC_SUB_TRC
+  #define PARABOLIC_SUBCYCLE_ON  YES
+#else
+  #define PARABOLIC_SUBCYCLE_ON  NO
+#endif
+
+#define PARABOLIC_SUB_STEP  66   /* Pseudo time-stepping label used to
+                                    compute the subcycled operators
+                                    alone */
+
+#if    (TRACER_DIFFUSION != EXPLICIT) || (SPECTRAL_VISCOSITY == YES) \
+    || (PARABOLIC_MG_ON == YES) || (PARABOLIC_SUBCYCLE_ON == YES)
+  #define PARABOLIC_SPLIT  YES
+#else
+  #define PARABOLIC_SPLIT  NO
+#endif
+
+#ifndef TRACER_STS_NU
+  #define TRACER_STS_NU  0.01   /* Damping factor of classic STS */
+#endif
+
+#define TRACER_SPLIT_STEP  64   /* Pseudo time-stepping label used to
+                                   compute the split tracer rhs alone */
+
+/* -- Tile activity mask for explicit tracer diffusion
+      (tracer_active.c): tiles of TRACER_TILE_SIZE zones where no
+      tracer jump exceeds TRACER_ACTIVE_EPS, within a halo of
+      TRACER_ACTIVE_HALO zones, are skipped by the tracer sweeps. -- */
+
+#ifndef TRACER_ACTIVE_MASK
+  #define TRACER_ACTIVE_MASK  NO
+#endif
+
+#ifndef TRACER_TILE_SIZE
+  #define TRACER_TILE_SIZE  8
+#endif
+
+#ifndef TRACER_ACTIVE_HALO
+  #define TRACER_ACTIVE_HALO  4
+#endif
+
+#ifndef TRACER_ACTIVE_EPS
+  #define TRACER_ACTIVE_EPS  1.e-12
+#endif
+
+#if (TRACER_ACTIVE_MASK == YES) && (TRACER_DIFFUSION == EXPLICIT)
+  #define TRACER_ACTIVE_MASK_ON  YES
+#else
+  #define TRACER_ACTIVE_MASK_ON  NO
+#endif
+
+/* -- Cartesian uniform-grid tracer gradient: GetTracerGradient()
+      computes only the normal component with a constant spacing.
+      Set TRACER_UNIFORM_GRID to YES in definitions.h to enable it;
+      the grid is checked at the first call to ParabolicRHS(). -- */
+
+#ifndef TRACER_UNIFORM_GRID
+  #define TRACER_UNIFORM_GRID  NO
+#endif
+
+#if (TRACER_UNIFORM_GRID == YES) && (GEOMETRY == CARTESIAN)
+  #define TRACER_UNIFORM_GRID_ON  YES
+#else
+  #define TRACER_UNIFORM_GRID_ON  NO
+#endif
+
+/* -- Primitive variables read by the tracer flux kernel
+      (RHS_TRACER_Flux()); TRACER_RHS() gathers and averages only
+      these along the pencil. -- */
+
+#define TRACER_FLUX_NVAR  1
+extern const int TracerFluxVars[TRACER_FLUX_NVAR];
+
+/* -- Number of adjacent X2 pencils processed together by the
+      X2 tracer sweep (tracer_rhs_batch.c). 1 disables batching. -- */
+
+#ifndef TRACER_JBATCH
+  #define TRACER_JBATCH  8
+#endif
+
+/* -- Wall-clock timers of the parabolic step (parabolic_timers.c),
+      written to the log file every log steps. Set PARABOLIC_TIMERS
+      to YES in definitions.h to enable them. -- */
+
+#ifndef PARABOLIC_TIMERS
+  #define PARABOLIC_TIMERS  NO
+#endif
+
+enum PARABOLIC_TIMER_LABELS{
+  PT_RHS,           /* ParabolicRHS(), whole call       */
+  PT_SWEEP,         /* + IDIR/JDIR/KDIR: sweeps          */
+  PT_STREAM = PT_SWEEP+3,   /* TiledPencilSweep()        */
+  PT_TRACER,        /* TRACER_RHS(), TRACER_RHS_Batch()  */
+  PT_FUSED,         /* ParabolicFusedRHS()               */
+  PT_TC,            /* TC_RHS()                          */
+  PT_VISC,          /* ViscousRHS()                      */
+  PT_SPLIT,         /* Operator-split stage              */
+  PT_UPDATE,        /* ParabolicUpdate() accumulation    */
+  PT_COUNT
+};
+
+#define RBOX_ZONES(b)  ((long)((b)->iend - (b)->ibeg + 1)* \
+                              ((b)->jend - (b)->jbeg + 1)* \
+                              ((b)->kend - (b)->kbeg + 1))
+
+#if PARABOLIC_TIMERS == YES
+  #define PTIMER_START(t)          double t = ParabolicTimerNow()
+  #define PTIMER_STOP(id, t, n)    ParabolicTimerAdd (id, t, n)
+#else
+  #define PTIMER_START(t)
+  #define PTIMER_STOP(id, t, n)
+#endif
+
+/* -- Asynchronous HDF5 snapshots (async_h5.c), written by a
+      background thread from at most ASYNC_H5_SLOTS staging
+      buffers. Set ASYNC_H5 to YES in definitions.h and add an
+      "async.h5  <dt>  <dt_checkpoint>" line to pluto.ini. -- */
+
+#ifndef ASYNC_H5
+  #define ASYNC_H5  NO
+#endif
+
+#ifndef ASYNC_H5_SLOTS
+  #define ASYNC_H5_SLOTS  2
+#endif
+
+/* -- Compressed .h5 datasets (hdf5_io.c), set by the
+      "h5_compress.<var>  <deflate>  <digits>" lines of pluto.ini
+      and shared by the dbl.h5 / flt.h5 output and async_h5.c. -- */
+
+#ifndef H5_COMPRESS_CHUNK
+  #define H5_COMPRESS_CHUNK  64   /* Rows per chunk of compressed datasets */
+#endif
+
+/* -- Diffusion constants in code units, derived from g_inputParam
+      (diffusion_constants.c) and read by all diffusion kernels. -- */
+
+typedef struct DiffusionConstants_ {
+  double nu_visc;              /* Kinematic viscosity, nu1 = rho*nu_visc    */
+  double kappa_tc;             /* Conductivity per unit density, kpar/rho   */
+  double phi_tc;               /* Saturation parameter of conduction        */
+  double nu_trc[NTRACER];      /* Tracer diffusivities                      */
+  int    trc_const;            /* 1 if nu_trc does not depend on position   */
+  int    on;                   /* 0 when DIFFUSION = 0 (all operators off)  */
+  double par[4];               /* U_FLOW, LENGTH, REYNOLDS, DIFFUSION of the
+                                  last build                                */
+} DiffusionConstants;
+
+/* -- Radix-2 FFT plan (fft.c) -- */
+
+typedef struct FFTPlan_ {
+  int     n;                   /* Transform length                          */
+  int     *rev;                /* Bit-reversal permutation                  */
+  double  *wr, *wi;            /* Twiddle factors exp(-2 pi i m/n)          */
+  struct FFTPlan_ *half;       /* Complex plan of n/2 points (real plans)   */
+} FFTPlan;
+
+/* -- Scratch workspace used by the parabolic pencil kernels.
+      One instance per thread, so that pencils can be processed
+      concurrently without sharing function-static buffers or
+      the g_dir / g_i / g_j / g_k globals. -- */
+
+typedef struct ParabolicWork_ {
+  int     dir;                 /* Sweep direction (IDIR, JDIR or KDIR)      */
+  int     i, j, k;             /* Pencil indices (the one along dir unused) */
+  int     nb;                  /* Number of adjacent pencils (batches)      */
+  double  **vn;                /* Primitive state along the pencil          */
+  double  **vi;                /* Interface state [nv][i]                   */
+  double  *nu1, *nu2;          /* Viscosity coefficients at interfaces      */
+  double  *kpar, *knor, *phi;  /* Conduction coefficients at interfaces     */
+  double  *fA;                 /* Area-weighted flux                        */
+  double  *inv_dl;             /* Inverse line element (curvilinear grids)  */
+  double  **tracer_flux;       /* Tracer flux at interfaces [i][trc]        */
+  double  ***gradTRC;          /* Tracer gradient [trc][i][0..2]            */
+  double  **par_flux;          /* Fused parabolic flux [i][nv]              */
+  double  *dcoeff_tc;          /* Thermal conduction coefficients [i]       */
+  double  *dcoeff_visc;        /* Viscosity coefficients [i]                */
+  double  ****C_tile;          /* Streamed inverse time step [op][k][j][i]  */
+  double  **batch_rho;         /* Batched density [j][column]               */
+  double  **batch_C;           /* Batched tracer [j][column]                */
+  double  **batch_flux;        /* Batched tracer flux [j][column]           */
+  double  dcoeff_trc[NTRACER]; /* Tracer diffusion coefficients             */
+} ParabolicWork;
+
+ParabolicWork *GetParabolicWork (int);
+double *GetPencilInverse_dl (ParabolicWork *, Grid *);
+
+int    DiffusionConstantsUpdate (void);
+const DiffusionConstants *DiffusionConstantsGet (void);
+
+void   ParabolicFusedRHS (const Data *, Data_Arr, ParabolicWork *,
+                          int, int, int, double, int, int, Grid *);
+
+void   Visc_nuPencil (double **, int, int, const ParabolicWork *, Grid *,
+                      double *, double *);
+void   TC_kappaPencil (double **, int, int, const ParabolicWork *, Grid *,
+                       double *, double *, double *);
+
+void   RHS_TRACER_Flux (double ****, ParabolicWork *, int, int, Grid *);
+void   TRACER_RHS (const Data *, Data_Arr, ParabolicWork *,
                double **, double, int, int, Grid *);
 
-void   GetTracerGradient (double ***, double **, int, int, Grid *);
+void   TRACER_RHS_Batch (const Data *, Data_Arr, ParabolicWork *, double,
+                         int, int, Grid *);
+
+void   TracerCheckUniformGrid (Grid *);
+
+void   OutputVarName (int, char *);
+void   XAvgCheck (const Data *, Grid *);
+void   XAvgWrite (const Data *, int *, int, int, Grid *);
+
+void   KHSpectraCheck (const Data *, Grid *);
+void   KHSpectraWrite (const Data *, double, Grid *);
+
+void   H5CompressInit (void);
+int    H5CompressReadBack (void);
+#ifdef H5_VERS_MAJOR   /* hdf5.h included */
+hid_t  H5CompressDcpl (const char *, int, const hsize_t *);
+#endif
+
+void   AsyncH5Check (const Data *, Grid *);
+void   AsyncH5Write (const Data *, int, int, Grid *);
+void   AsyncH5Flush (void);
+
+void   ParabolicBenchCheck (const Data *, Grid *);
+void   ParabolicBench (const Data *, int, Grid *);
+
+void   ParabolicTimersInit (void);
+double ParabolicTimerNow (void);
+void   ParabolicTimerAdd (int, double, long);
+void   ParabolicTimersPause (int);
+void   ParabolicTimersLog (void);
+void   GetTracerGradient (double ***, double **, int, int,
+                          const ParabolicWork *, Grid *);
+
+void   TracerSplitUpdate (const Data *, double ****, RBox *, double, Grid *);
+void   TracerADIUpdate (const Data *, double ****, RBox *, double, Grid *);
+void   ParabolicMGUpdate (const Data *, double ****, RBox *, double, Grid *);
+void   ParabolicSubcycle (const Data *, double ****, RBox *, double, Grid *);
+void   TracerActiveBuild (const Data *, Grid *);
+int    TracerActiveRun (const ParabolicWork *, int, int, int *);
+void   SpectralDiffusion (const Data *, double ****, RBox *, double, Grid *);
+
+FFTPlan *FFT_CreatePlan (int, int);
+void   FFT_Complex (FFTPlan *, double *, int);
+void   FFT_RealForward (FFTPlan *, double *, double *);
+void   FFT_RealInverse (FFTPlan *, double *, double *);
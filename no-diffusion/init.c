@@ -1,262 +0,0 @@
-/* ///////////////////////////////////////////////////////////////////// */
-/*! 
-  \file  
-  \brief Contains basic functions for problem initialization.
-
-  The init.c file collects most of the user-supplied functions useful 
-  for problem configuration.
-  It is automatically searched for by the makefile.
-
-  \author A. Mignone (mignone@ph.unito.it)
-  \date   March 5, 2017
-*/
-/* ///////////////////////////////////////////////////////////////////// */
-#include "pluto.h"
-
-/* ********************************************************************* */
-void Init (double *v, double x1, double x2, double x3)
-/*! 
- * The Init() function can be used to assign initial conditions as
- * as a function of spatial position.
- *
- * \param [out] v   a pointer to a vector of primitive variables
- * \param [in] x1   coordinate point in the 1st dimension
- * \param [in] x2   coordinate point in the 2nd dimension
- * \param [in] x3   coordinate point in the 3rdt dimension
- *
- * The meaning of x1, x2 and x3 depends on the geometry:
- * \f[ \begin{array}{cccl}
- *    x_1  & x_2    & x_3  & \mathrm{Geometry}    \\ \noalign{\medskip}
- *     \hline
- *    x    &   y    &  z   & \mathrm{Cartesian}   \\ \noalign{\medskip}
- *    R    &   z    &  -   & \mathrm{cylindrical} \\ \noalign{\medskip}
- *    R    & \phi   &  z   & \mathrm{polar}       \\ \noalign{\medskip}
- *    r    & \theta & \phi & \mathrm{spherical} 
- *    \end{array}
- *  \f]
- *
- * Variable names are accessed by means of an index v[nv], where
- * nv = RHO is density, nv = PRS is pressure, nv = (VX1, VX2, VX3) are
- * the three components of velocity, and so forth.
- *
- *********************************************************************** */
-{
-}
-
-/* ********************************************************************* */
-void InitDomain (Data *d, Grid *grid)
-/*! 
- * Assign initial condition by looping over the computational domain.
- * Called after the usual Init() function to assign initial conditions
- * on primitive variables.
- * Value assigned here will overwrite those prescribed during Init().
- *
- *
- *********************************************************************** */
-{
-  int   i, j, k, nv;
-  double  *x, *y, *z;
-  g_gamma = 5./3.;
-
-  x = grid->x[IDIR];
-  y = grid->x[JDIR];
-  z = grid->x[KDIR];
-
-  double y1    = g_inputParam[Y1];
-  double y2    = g_inputParam[Y2];
-  double sig   = g_inputParam[SIGMA];
-  double a     = g_inputParam[TANH_A];
-  double amp   = g_inputParam[AMP];
-  double uflow = g_inputParam[U_FLOW];
-  double P0    = g_inputParam[PRS0];
-  double del_rho_by_rho0 = g_inputParam[DEL_RHO_BY_RHO0];
-  
-  TOT_LOOP(k,j,i){
-    d->Vc[RHO][k][j][i] = 1 + del_rho_by_rho0 * 
-                              0.5 * ( tanh((y[j]-y1)/a) - tanh((y[j]-y2)/a) );
-    d->Vc[PRS][k][j][i] = P0;
-    DIM_EXPAND(
-    d->Vc[VX1][k][j][i] = uflow * ( tanh((y[j]-y1)/a) - tanh((y[j]-y2)/a) - 1 );,
-    d->Vc[VX2][k][j][i] = amp * sin(2*CONST_PI*x[i]) * 
-                                ( exp(-pow((y[j]-y1)/sig,2)) + exp(-pow((y[j]-y2)/sig,2)) );,
-    d->Vc[VX3][k][j][i] = 0.;)
-    d->Vc[TRC][k][j][i] = 0.5 * ( tanh((y[j]-y2)/a) - tanh((y[j]-y1)/a) + 2 );  
-  }
-
-}
-
-/* ********************************************************************* */
-void Analysis (const Data *d, Grid *grid)
-/*! 
- *  Perform runtime data analysis.
- *
- * \param [in] d the PLUTO Data structure
- * \param [in] grid   pointer to array of Grid structures  
- *
- *********************************************************************** */
-{
-
-}
-#if PHYSICS == MHD
-/* ********************************************************************* */
-void BackgroundField (double x1, double x2, double x3, double *B0)
-/*!
- * Define the component of a static, curl-free background 
- * magnetic field.
- *
- * \param [in] x1  position in the 1st coordinate direction \f$x_1\f$
- * \param [in] x2  position in the 2nd coordinate direction \f$x_2\f$
- * \param [in] x3  position in the 3rd coordinate direction \f$x_3\f$
- * \param [out] B0 array containing the vector componens of the background
- *                 magnetic field
- *********************************************************************** */
-{
-   B0[0] = 0.0;
-   B0[1] = 0.0;
-   B0[2] = 0.0;
-}
-#endif
-
-/* ********************************************************************* */
-void UserDefBoundary (const Data *d, RBox *box, int side, Grid *grid) 
-/*! 
- *  Assign user-defined boundary conditions.
- *
- * \param [in,out] d  pointer to the PLUTO data structure containing
- *                    cell-centered primitive quantities (d->Vc) and 
- *                    staggered magnetic fields (d->Vs, when used) to 
- *                    be filled.
- * \param [in] box    pointer to a RBox structure containing the lower
- *                    and upper indices of the ghost zone-centers/nodes
- *                    or edges at which data values should be assigned.
- * \param [in] side   specifies the boundary side where ghost zones need
- *                    to be filled. It can assume the following 
- *                    pre-definite values: X1_BEG, X1_END,
- *                                         X2_BEG, X2_END, 
- *                                         X3_BEG, X3_END.
- *                    The special value side == 0 is used to control
- *                    a region inside the computational domain.
- * \param [in] grid  pointer to an array of Grid structures.
- *
- *********************************************************************** */
-{
-  int   i, j, k, nv;
-  double  *x1, *x2, *x3;
-
-  x1 = grid->x[IDIR];
-  x2 = grid->x[JDIR];
-  x3 = grid->x[KDIR];
-
-  if (side == 0) {    /* -- check solution inside domain -- */
-    DOM_LOOP(k,j,i){}
-  }
-
-  if (side == X1_BEG){  /* -- X1_BEG boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-
-  if (side == X1_END){  /* -- X1_END boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-
-  if (side == X2_BEG){  /* -- X2_BEG boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-
-  if (side == X2_END){  /* -- X2_END boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-
-  if (side == X3_BEG){  /* -- X3_BEG boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-
-  if (side == X3_END){  /* -- X3_END boundary -- */
-    if (box->vpos == CENTER) {
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X1FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X2FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }else if (box->vpos == X3FACE){
-      BOX_LOOP(box,k,j,i){  }
-    }
-  }
-}
-
-#if BODY_FORCE != NO
-/* ********************************************************************* */
-void BodyForceVector(double *v, double *g, double x1, double x2, double x3)
-/*!
- * Prescribe the acceleration vector as a function of the coordinates
- * and the vector of primitive variables *v.
- *
- * \param [in] v  pointer to a cell-centered vector of primitive 
- *                variables
- * \param [out] g acceleration vector
- * \param [in] x1  position in the 1st coordinate direction \f$x_1\f$
- * \param [in] x2  position in the 2nd coordinate direction \f$x_2\f$
- * \param [in] x3  position in the 3rd coordinate direction \f$x_3\f$
- *
- *********************************************************************** */
-{
-  g[IDIR] = 0.0;
-  g[JDIR] = 0.0;
-  g[KDIR] = 0.0;
-}
-/* ********************************************************************* */
-double BodyForcePotential(double x1, double x2, double x3)
-/*!
- * Return the gravitational potential as function of the coordinates.
- *
- * \param [in] x1  position in the 1st coordinate direction \f$x_1\f$
- * \param [in] x2  position in the 2nd coordinate direction \f$x_2\f$
- * \param [in] x3  position in the 3rd coordinate direction \f$x_3\f$
- * 
- * \return The body force potential \f$ \Phi(x_1,x_2,x_3) \f$.
- *
- *********************************************************************** */
-{
-  return 0.0;
-}
-#endif
@@ -0,0 +1,276 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief In-situ micro-benchmarks of the parabolic kernels.
+
+  Times GetTracerGradient(), RHS_TRACER_Flux(), TRACER_RHS() and
+  ParabolicRHS() on their own, on the initial KH fields of the run.
+  The benchmark is enabled by a line in the [Static Grid Output]
+  block of pluto.ini:
+  \verbatim
+  bench   <nrep>   [exit]
+  \endverbatim
+  and runs once, at the first call of Analysis().
+  With \c exit the code stops after the benchmark, so that kernel
+  changes can be measured without running a full simulation.
+
+  Pencil kernels are timed on square (cubic in 3D) sub-boxes of the
+  local domain of increasing size n = 16, 32, ..., for every sweep
+  direction, on a single thread, pencil after pencil.
+  ParabolicRHS() (all operators, all directions) uses all threads and
+  is timed on the whole local domain only: part of its work (clearing
+  the time step factors, building the active tracer mask, filling the
+  temperature) spans the whole grid whatever the box, and would
+  inflate the cost per zone of smaller boxes.
+  Every measurement is repeated \c nrep times, and the best time is
+  kept.
+  For every kernel the log file reports the zone updates per second,
+  an estimate of the compulsory memory traffic per zone (see
+  BenchBytes()) and the corresponding bandwidth.
+  The number of tracers is a compile-time constant and is reported
+  with the results; to compare several values without rebuilding
+  PLUTO, the standalone driver in bench/ (bench_main.c) compiles these
+  sources against a minimal grid and data setup, once per NTRACER
+  (\c make \c sweep there).
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#ifdef _OPENMP
+ #include <omp.h>
+#else
+ #include <time.h>
+#endif
+
+enum BENCH_KERNELS{
+  BK_GRAD,          /* GetTracerGradient()  */
+  BK_FLUX,          /* RHS_TRACER_Flux()    */
+  BK_TRC,           /* TRACER_RHS()         */
+  BK_PAR,           /* ParabolicRHS()       */
+  BK_COUNT
+};
+
+static const char *bench_name[BK_COUNT] = {
+  "GetTracerGradient", "RHS_TRACER_Flux", "TRACER_RHS", "ParabolicRHS"};
+
+static double BenchNow (void);
+static double BenchBytes (int);
+static double BenchPencils (int, int, const Data *, Data_Arr, RBox *, Grid *);
+
+/* ********************************************************************* */
+void ParabolicBenchCheck (const Data *d, Grid *grid)
+/*!
+ * Run the benchmark at the first call if pluto.ini has a bench line.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  static int first = 1;
+
+  if (!first) return;
+  first = 0;
+  if (!ParamExist ("bench")) return;
+
+  ParabolicBench (d, atoi(ParamFileGet("bench", 1)), grid);
+
+  if (ParamFileHasBoth ("bench", "exit")){
+    printLog ("> ParabolicBench(): done, exiting\n");
+    QUIT_PLUTO(0);
+  }
+}
+
+/* ********************************************************************* */
+void ParabolicBench (const Data *d, int nrep, Grid *grid)
+/*!
+ * Time the pencil kernels on sub-boxes of increasing size and
+ * ParabolicRHS() on the local domain, and write the results to the
+ * log file.
+ * The integration stage and the parabolic timers are left as found.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] nrep   number of repetitions of every measurement
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    n, nmax, dir, kern, r, nthreads = 1, stage = g_intStage;
+  long   ncell;
+  double t0, t, tbest, rate;
+  Data_Arr dU;
+  RBox   box;
+
+  nrep = MAX(nrep, 1);
+  nmax = NX1;
+  if (INCLUDE_JDIR) nmax = MIN(nmax, NX2);
+  if (INCLUDE_KDIR) nmax = MIN(nmax, NX3);
+  #ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+  #endif
+
+  dU = ARRAY_4D(NX3_TOT, NX2_TOT, NX1_TOT, NVAR, double);
+  DiffusionConstantsUpdate ();
+  GetParabolicWork (0);
+  #if PARABOLIC_TIMERS == YES
+  ParabolicTimersPause (1);
+  #endif
+
+  printLog ("> ParabolicBench(): NTRACER = %d, %d repetitions, %d thread(s)\n",
+            NTRACER, nrep, nthreads);
+  printLog ("  %-18s %5s %4s %12s %10s %10s\n",
+            "kernel", "n", "dir", "zones/s", "B/zone", "GB/s");
+
+  for (n = 16; n <= nmax; n *= 2){
+    box.ibeg = IBEG; box.iend = IBEG + n - 1;
+    box.jbeg = JBEG; box.jend = JBEG + (INCLUDE_JDIR ? n - 1 : 0);
+    box.kbeg = KBEG; box.kend = KBEG + (INCLUDE_KDIR ? n - 1 : 0);
+    ncell = RBOX_ZONES(&box);
+
+  /* -- Pencil kernels, one direction at a time -- */
+
+    for (kern = BK_GRAD; kern <= BK_TRC; kern++){
+      for (dir = 0; dir < DIMENSIONS; dir++){
+        tbest = 1.e30;
+        for (r = 0; r < nrep; r++){
+          t     = BenchPencils (kern, dir, d, dU, &box, grid);
+          tbest = MIN(tbest, t);
+        }
+        rate = ncell/tbest;
+        printLog ("  %-18s %5d %4d %12.4e %10.1f %10.3f\n", bench_name[kern],
+                  n, dir + 1, rate, BenchBytes(kern), rate*BenchBytes(kern)/1.e9);
+      }
+    }
+  }
+
+/* -- Whole parabolic rhs, on the local domain -- */
+
+  box.ibeg = IBEG; box.iend = IEND;
+  box.jbeg = JBEG; box.jend = JEND;
+  box.kbeg = KBEG; box.kend = KEND;
+  ncell = RBOX_ZONES(&box);
+
+  tbest = 1.e30;
+  for (r = 0; r < nrep; r++){
+    g_intStage = 1;
+    t0    = BenchNow();
+    ParabolicRHS (d, dU, &box, NULL, EXPLICIT, 1.0, grid);
+    tbest = MIN(tbest, BenchNow() - t0);
+  }
+  rate = ncell/tbest;
+  printLog ("  %-18s %5s %4s %12.4e %10.1f %10.3f\n", bench_name[BK_PAR],
+            "local", "all", rate, BenchBytes(BK_PAR), rate*BenchBytes(BK_PAR)/1.e9);
+
+  FreeArray4D ((void *) dU);
+  g_intStage = stage;
+  #if PARABOLIC_TIMERS == YES
+  ParabolicTimersPause (0);
+  #endif
+}
+
+/* ********************************************************************* */
+static double BenchPencils (int kern, int dir, const Data *d, Data_Arr dU,
+                            RBox *box, Grid *grid)
+/*!
+ * Apply kernel kern to all the pencils of box in the direction dir,
+ * on the calling thread, and return the elapsed time.
+ *********************************************************************** */
+{
+  int    l, m, nv, o, p, beg, end, obeg, oend, pbeg, pend;
+  double t0, t = 0.0;
+  ParabolicWork *w = GetParabolicWork (0);
+
+  if (dir == IDIR){
+    beg  = box->ibeg; end  = box->iend;
+    obeg = box->kbeg; oend = box->kend;
+    pbeg = box->jbeg; pend = box->jend;
+  }else if (dir == JDIR){
+    beg  = box->jbeg; end  = box->jend;
+    obeg = box->kbeg; oend = box->kend;
+    pbeg = box->ibeg; pend = box->iend;
+  }else{
+    beg  = box->kbeg; end  = box->kend;
+    obeg = box->jbeg; oend = box->jend;
+    pbeg = box->ibeg; pend = box->iend;
+  }
+
+  for (o = obeg; o <= oend; o++){
+  for (p = pbeg; p <= pend; p++){
+    w->dir = dir;
+    w->nb  = 1;
+    if      (dir == IDIR) {w->k = o; w->j = p; w->i = 0;}
+    else if (dir == JDIR) {w->k = o; w->i = p; w->j = 0;}
+    else                  {w->j = o; w->i = p; w->k = 0;}
+
+  /* -- RHS_TRACER_Flux() expects the needed primitives in w->vn
+        (gathered by TRACER_RHS()): gather them untimed -- */
+
+    if (kern == BK_FLUX){
+      for (m = 0; m < TRACER_FLUX_NVAR; m++){
+        nv = TracerFluxVars[m];
+        for (l = beg-1; l <= end+1; l++){
+          if      (dir == IDIR) w->vn[l][nv] = d->Vc[nv][w->k][w->j][l];
+          else if (dir == JDIR) w->vn[l][nv] = d->Vc[nv][w->k][l][w->i];
+          else                  w->vn[l][nv] = d->Vc[nv][l][w->j][w->i];
+        }
+      }
+    }
+
+    t0 = BenchNow();
+    if (kern == BK_GRAD){
+      for (m = 0; m < NTRACER; m++){
+        GetTracerGradient (d->Vc[TRC+m], w->gradTRC[m], beg-1, end, w, grid);
+      }
+    }else if (kern == BK_FLUX){
+      RHS_TRACER_Flux (d->Vc+TRC, w, beg-1, end, grid);
+    }else{
+      TRACER_RHS (d, dU, w, NULL, 1.0, beg, end, grid);
+    }
+    t += BenchNow() - t0;
+  }}
+  return t;
+}
+
+/* ********************************************************************* */
+static double BenchBytes (int kern)
+/*!
+ * Estimate of the compulsory memory traffic per zone (bytes) of
+ * kernel kern, counting each array element read or written once:
+ * - GetTracerGradient(): tracer read, 3 gradient components written;
+ * - RHS_TRACER_Flux(): gradient, plus the TracerFluxVars read and
+ *   the flux written;
+ * - TRACER_RHS(): flux, plus the TracerFluxVars gather and the
+ *   read-modify-write of the tracer rhs;
+ * - ParabolicRHS(): per direction, NVAR primitives read and NVAR rhs
+ *   components read and written, per interior zone of the local
+ *   domain. Its whole-grid work (time step factors, tracer mask,
+ *   temperature) is timed but not counted, so the bandwidth is a
+ *   lower bound.
+ *********************************************************************** */
+{
+  double b, dbl = sizeof(double);
+
+  b = NTRACER*4*dbl;                                     /* Gradient */
+  if (kern == BK_GRAD) return b;
+  b += TRACER_FLUX_NVAR*dbl + NTRACER*dbl;               /* Flux     */
+  if (kern == BK_FLUX) return b;
+  b += TRACER_FLUX_NVAR*dbl + NTRACER*2*dbl;             /* Rhs      */
+  if (kern == BK_TRC) return b;
+  return DIMENSIONS*3*NVAR*dbl;
+}
+
+/* ********************************************************************* */
+static double BenchNow (void)
+/*!
+ * Return the wall-clock time in seconds.
+ *********************************************************************** */
+{
+  #ifdef _OPENMP
+  return omp_get_wtime();
+  #else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1.e-9*ts.tv_nsec;
+  #endif
+}
@@ -0,0 +1,216 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Fused pencil kernel for tracer diffusion, viscosity and
+         thermal conduction.
+
+  ParabolicFusedRHS() replaces the sequence TRACER_RHS(), TC_RHS(),
+  ViscousRHS() on a single pencil.
+  The primitive state is gathered from \c d->Vc once, interface averages
+  and gradients are computed once, and the tracer, viscous and
+  conductive fluxes are obtained in one pass over the interfaces:
+  \f[
+    \vec{F}_C = \rho\nu_C\nabla C \,,\qquad
+    \tens{\Pi} = \nu_1\left[\nabla\vec{v} + (\nabla\vec{v})^T
+                 - \frac{2}{3}(\nabla\cdot\vec{v})\tens{I}\right]
+                 + \nu_2(\nabla\cdot\vec{v})\tens{I} \,,\qquad
+    \vec{F}_c = \frac{F_{\rm sat}}{F_{\rm sat} + |\kappa\nabla T|}
+                \kappa\nabla T
+  \f]
+  where \f$ F_{\rm sat} = 5\phi\rho c_{\rm iso}^3\f$.
+  The energy flux is \f$ \vec{v}\cdot\tens{\Pi} + \vec{F}_c\f$.
+
+  Interface states are stored per variable (\c w->vi[nv][l]) and the
+  coefficients of the whole pencil are obtained with one call to
+  Visc_nuPencil() and TC_kappaPencil().
+
+  Only the HD module in Cartesian coordinates with the ideal EOS is
+  supported (see ::PARABOLIC_FUSED_ON in local_pluto.h); any other
+  configuration uses the separate operators.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if PARABOLIC_FUSED_ON == YES
+
+/* ********************************************************************* */
+static double TransverseDerivative (double ***Q, int dir, int t,
+                                    int i, int j, int k, Grid *grid)
+/*!
+ * Derivative of Q in the direction t at the interface between
+ * zone (i,j,k) and its right neighbour in the direction dir, t != dir.
+ *********************************************************************** */
+{
+  int di = (dir == IDIR), dj = (dir == JDIR), dk = (dir == KDIR);
+  int ti = (t   == IDIR), tj = (t   == JDIR), tk = (t   == KDIR);
+  int lt = (t == IDIR ? i : (t == JDIR ? j : k));
+
+  return 0.25*(  Q[k+tk][j+tj][i+ti] + Q[k+tk+dk][j+tj+dj][i+ti+di]
+               - Q[k-tk][j-tj][i-ti] - Q[k-tk+dk][j-tj+dj][i-ti+di])
+             *grid->inv_dx[t][lt];
+}
+
+/* ********************************************************************* */
+void ParabolicFusedRHS (const Data *d, Data_Arr dU, ParabolicWork *w,
+                        int incl_trc, int incl_tc, int incl_visc, double dt,
+                        int beg, int end, Grid *grid)
+/*!
+ * \param [in]     d          pointer to PLUTO Data structure
+ * \param [out]    dU         a 4D array containing conservative variables
+ *                            increment
+ * \param [in,out] w          pointer to the pencil workspace. On output,
+ *                            w->dcoeff_trc, w->dcoeff_tc and
+ *                            w->dcoeff_visc contain the diffusion
+ *                            coefficients of the three operators.
+ * \param [in]     incl_trc   include tracer diffusion when != 0
+ * \param [in]     incl_tc    include thermal conduction when != 0
+ * \param [in]     incl_visc  include viscosity when != 0
+ * \param [in]     dt         the current time-step
+ * \param [in]     beg,end    initial and final zone indices
+ * \param [in]     grid       pointer to Grid structure.
+ *
+ *********************************************************************** */
+{
+  int    i = w->i, j = w->j, k = w->k;
+  int    dir = w->dir;
+  int    l, m, t, nv, n;
+  int    ic, jc, kc;
+  double *dx      = grid->dx[dir];
+  double *inv_dx  = grid->inv_dx[dir];
+  double *inv_dxi = grid->inv_dxi[dir];
+  double **vn   = w->vn;
+  double **vi   = w->vi;
+  double **flux = w->par_flux;
+  double *T     = w->fA;
+  double *nu1 = w->nu1, *nu2 = w->nu2, *kpar = w->kpar, *phi = w->phi;
+  double dvdx[COMPONENTS][3], gradT[3];
+  double wl, wr, divV, tau, Feng;
+  double Fcl, Fmag, Fsat, sqT, alpha, dtdx, *dUc;
+
+  const double *nu_dye = DiffusionConstantsGet()->nu_trc;
+
+/* --------------------------------------------------------
+   1. Gather the primitive state (and temperature) once
+   -------------------------------------------------------- */
+
+  if (dir == IDIR){
+    for (l = beg-1; l <= end+1; l++) NVAR_LOOP(nv) vn[l][nv] = d->Vc[nv][k][j][l];
+  }else if (dir == JDIR){
+    for (l = beg-1; l <= end+1; l++) NVAR_LOOP(nv) vn[l][nv] = d->Vc[nv][k][l][i];
+  }else{
+    for (l = beg-1; l <= end+1; l++) NVAR_LOOP(nv) vn[l][nv] = d->Vc[nv][l][j][i];
+  }
+  if (incl_tc){
+    for (l = beg-1; l <= end+1; l++) T[l] = vn[l][PRS]/vn[l][RHO];
+  }
+
+  for (n = 0; n < NTRACER; n++) w->dcoeff_trc[n] = fabs(nu_dye[n]);
+
+/* --------------------------------------------------------
+   2. Interface values and pencil coefficients
+   -------------------------------------------------------- */
+
+  for (l = beg-1; l <= end; l++){
+    wl = dx[l]/(dx[l] + dx[l+1]);
+    wr = 1.0 - wl;
+    NVAR_LOOP(nv) vi[nv][l] = wl*vn[l][nv] + wr*vn[l+1][nv];
+  }
+
+  if (incl_visc) Visc_nuPencil (vi, beg-1, end, w, grid, nu1, nu2);
+  if (incl_tc)   TC_kappaPencil (vi, beg-1, end, w, grid, kpar, w->knor, phi);
+
+/* --------------------------------------------------------
+   3. Loop over interfaces: differentiate and build all
+      fluxes in one pass.
+   -------------------------------------------------------- */
+
+  for (l = beg-1; l <= end; l++){
+
+    ic = (dir == IDIR ? l : i);
+    jc = (dir == JDIR ? l : j);
+    kc = (dir == KDIR ? l : k);
+
+  /* -- 3a. Tracer flux -- */
+
+    if (incl_trc) for (n = 0; n < NTRACER; n++){
+      flux[l][TRC+n] = vi[RHO][l]*nu_dye[n]*(vn[l+1][TRC+n] - vn[l][TRC+n])*inv_dxi[l];
+    }
+
+  /* -- 3b. Viscous stress and viscous energy flux -- */
+
+    Feng = 0.0;
+    if (incl_visc){
+      for (m = 0; m < COMPONENTS; m++){
+        for (t = 0; t < 3; t++){
+          if (t == dir) {
+            dvdx[m][t] = (vn[l+1][VX1+m] - vn[l][VX1+m])*inv_dxi[l];
+          }else if (t < DIMENSIONS){
+            dvdx[m][t] = TransverseDerivative (d->Vc[VX1+m], dir, t,
+                                               ic, jc, kc, grid);
+          }else{
+            dvdx[m][t] = 0.0;
+          }
+        }
+      }
+      divV = 0.0;
+      for (m = 0; m < DIMENSIONS; m++) divV += dvdx[m][m];
+
+      for (m = 0; m < COMPONENTS; m++){
+        tau  = nu1[l]*(dvdx[m][dir] + dvdx[dir][m]);
+        if (m == dir) tau += (nu2[l] - 2.0/3.0*nu1[l])*divV;
+        flux[l][MX1+m] = tau;
+        Feng += vi[VX1+m][l]*tau;
+      }
+      w->dcoeff_visc[l] = MAX(nu1[l], nu2[l])/vi[RHO][l];
+    }
+
+  /* -- 3c. Saturated conductive flux -- */
+
+    if (incl_tc){
+      gradT[0] = gradT[1] = gradT[2] = 0.0;
+      for (t = 0; t < DIMENSIONS; t++){
+        if (t == dir) gradT[t] = (T[l+1] - T[l])*inv_dxi[l];
+        else          gradT[t] = TransverseDerivative (d->Tc, dir, t,
+                                                       ic, jc, kc, grid);
+      }
+      Fcl   = kpar[l]*gradT[dir];
+      Fmag  = kpar[l]*sqrt(gradT[0]*gradT[0] + gradT[1]*gradT[1]
+                                             + gradT[2]*gradT[2]);
+      sqT   = sqrt(vi[PRS][l]/vi[RHO][l]);
+      Fsat  = 5.0*phi[l]*vi[RHO][l]*sqT*sqT*sqT;
+      alpha = Fsat/(Fsat + Fmag);
+
+      Feng += alpha*Fcl;
+      w->dcoeff_tc[l] = alpha*kpar[l]*(g_gamma - 1.0)/vi[RHO][l];
+    }
+    flux[l][ENG] = Feng;
+  }
+
+/* --------------------------------------------------------
+   4. Flux differences (Cartesian: dV = dx*A, A = 1)
+   -------------------------------------------------------- */
+
+  for (l = beg; l <= end; l++){
+    if      (dir == IDIR) dUc = dU[k][j][l];
+    else if (dir == JDIR) dUc = dU[k][l][i];
+    else                  dUc = dU[l][j][i];
+
+    dtdx = dt*inv_dx[l];
+    if (incl_trc) for (n = 0; n < NTRACER; n++){
+      dUc[TRC+n] += dtdx*(flux[l][TRC+n] - flux[l-1][TRC+n]);
+    }
+    if (incl_visc){
+      for (m = 0; m < COMPONENTS; m++){
+        dUc[MX1+m] += dtdx*(flux[l][MX1+m] - flux[l-1][MX1+m]);
+      }
+    }
+    if (incl_visc || incl_tc){
+      dUc[ENG] += dtdx*(flux[l][ENG] - flux[l-1][ENG]);
+    }
+  }
+}
+
+#endif /* PARABOLIC_FUSED_ON == YES */
@@ -0,0 +1,1006 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Implicit viscosity and thermal conduction with geometric
+         multigrid.
+
+  When ::PARABOLIC_MG is set to YES, viscosity and thermal conduction
+  (declared EXPLICIT in definitions.h) are removed from the explicit
+  stages and advanced implicitly over the whole step, at its
+  beginning, with density fixed:
+  \f[
+    \rho\vec{v}^* = \rho\vec{v}^n + \Delta t\Big[(1-\theta)\vec{L}_m^n
+                    + \theta\vec{L}_m^*\Big] \,,\qquad
+    E^* = E^n + \Delta t\Big[(1-\theta)L_E^n + \theta L_E^*\Big]
+  \f]
+  where \f$\vec{L}_m\f$ and \f$L_E\f$ are the momentum and energy
+  right hand sides of the two operators and \f$\theta\f$ =
+  ::PARABOLIC_MG_THETA (1: backward Euler, 1/2: Crank-Nicolson).
+
+  The nonlinear system for \f$\vec{v}^*\f$ and \f$T^* = p^*\!/\rho\f$
+  is solved by defect correction:
+  - the residuals are evaluated with ParabolicRHS(), i.e. with the
+    same flux kernels used by the explicit scheme, on a shallow copy
+    of the data structure holding the current iterate;
+  - corrections are obtained from the scalar problems
+    \f$\sigma\,\delta - \nabla\cdot(K\nabla\delta) = R\f$, with
+    \f$\sigma = \rho,\; K = \theta\Delta t\rho\nu\f$ for every
+    velocity component and \f$\sigma = \rho/(\Gamma-1),\;
+    K = \theta\Delta t\alpha\kappa_\parallel\f$ for the temperature,
+    with the saturation factor \f$\alpha\f$ of the current iterate
+    (lagged coefficient, which bounds the Jacobian of the saturated
+    flux from above), each solved approximately by ::PARABOLIC_MG_CYCLES
+    matrix-free V-cycles.
+  Iterations stop when the corrections, relative to the largest
+  velocity and temperature at \f$t^n\f$, drop below
+  ::PARABOLIC_MG_TOL.
+  The momentum and energy increments follow from the fluxes of the
+  last iterate, so that momentum and total energy are conserved to
+  round-off.
+
+  Multigrid levels are obtained by halving the local block in every
+  direction (cell-centred, averaging restriction and piecewise
+  constant prolongation, red-black Gauss-Seidel smoothing).
+  Ghost zones are exchanged with the neighbouring blocks on every
+  level; periodic directions are periodic on all levels; at physical
+  boundaries corrections vanish in the ghost zones, and the coupling
+  with the boundary conditions is recovered by the outer iterations,
+  whose residual includes the ghost zones.
+  With more than one rank, blocks are halved while every block can be
+  and the level has more than ::MG_GATHER_ZONES zones; the last
+  distributed level is then gathered onto rank 0, which computes its
+  coarse-grid correction on the whole domain with the remaining
+  levels and scatters it back.
+  Only operators declared EXPLICIT are solved here; the others keep
+  their core time stepping.
+
+  The increments are returned as rates and added by ParabolicUpdate()
+  to every stage, as for the other split operators.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if PARABOLIC_MG_ON == YES
+
+#define MG_MAX_LEVELS  16
+#define MG_NPRE         2    /* Pre-smoothing sweeps          */
+#define MG_NPOST        2    /* Post-smoothing sweeps         */
+#define MG_NCOARSE     40    /* Sweeps on the coarsest level  */
+#define MG_GATHER_ZONES 4096 /* Gather smaller levels on rank 0 */
+
+enum MG_COEFF_SETS{
+  MG_VISC,          /* sigma = rho,       K = theta dt rho nu_visc */
+  MG_TC,            /* sigma = rho/(g-1), K = theta dt rho kappa_tc */
+  MG_NSET
+};
+
+typedef struct MGLevel_ {
+  int    n[3];                 /* Interior zones (1 if unused)             */
+  int    g[3];                 /* Ghost zones (1, or 0 if unused)          */
+  double *dx[3];               /* Zone widths [l]                          */
+  double *inv_dxi[3];          /* Inverse distance of centers l-1, l       */
+  double ***u, ***f, ***r;     /* Solution, rhs and residual               */
+  double ***sig[MG_NSET];      /* Diagonal term                            */
+  double ***K[MG_NSET][3];     /* Face coefficient, face l-1/2 at index l  */
+  int    nb[3][2];             /* Rank of the left/right neighbour, or -1  */
+  double *buf[2];              /* Ghost exchange buffers                   */
+} MGLevel;
+
+static MGLevel mg[MG_MAX_LEVELS];
+static int     nlev, nloc, periodic[3];
+
+#ifdef PARALLEL
+ #define MG_PEER(r)  ((r) < 0 || (r) == prank ? MPI_PROC_NULL : (r))
+static int     nrank, *blk, *cnt, *dsp;
+static double  *sbuf, *gbuf;
+static void    MGCounts (const int *);
+static void    MGGather (double ***, double ***, int);
+static void    MGScatter (double ***, double ***);
+#endif
+
+static void   MGInit (Grid *);
+static void   MGNeighbours (int [3][2], Grid *);
+static void   MGLevelInit (MGLevel *, MGLevel *, int, Grid *);
+static int    MGCanHalve (MGLevel *);
+static void   MGSpacing (MGLevel *, Grid *);
+static int    MGPlane (MGLevel *, double ***, int, int, double *, int);
+static void   MGSetCoefficients (int, const Data *, double, Grid *);
+static void   MGSolve (int, double ***, double ***);
+static void   MGCycle (int, int);
+static void   MGSmooth (MGLevel *, int, int);
+static void   MGResidual (MGLevel *, int);
+static void   MGGhosts (MGLevel *, double ***);
+static double MGApply (MGLevel *, int, double ***, int, int, int, double *);
+
+/* ********************************************************************* */
+void ParabolicMGUpdate (const Data *d, double ****dU, RBox *box,
+                        double dt, Grid *grid)
+/*!
+ * Advance velocity and energy by viscosity and thermal conduction over
+ * dt and store the conservative increments divided by dt.
+ *
+ * \param [in]  d      pointer to PLUTO Data structure (state at t^n,
+ *                     boundaries already assigned)
+ * \param [out] dU     the rate dU[nv][k][j][i] = Delta(U_nv)/dt for
+ *                     momenta and energy; other components are left
+ *                     untouched.
+ * \param [in]  box    box defining the zones to be updated
+ * \param [in]  dt     the time step
+ * \param [in]  grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, m, nv, it;
+  double th = PARABOLIC_MG_THETA, g1 = g_gamma - 1.0;
+  double cor[2], scale[2];
+  static double ****rhs, ****rhs0, ***vs[COMPONENTS], ***ps, ***En;
+  static double ***R, ***delta;
+  double ***Vc[NVAR];
+  Data   ds = *d;
+
+  if (rhs == NULL){
+    MGInit (grid);
+    rhs  = ARRAY_4D(NX3_MAX, NX2_MAX, NX1_MAX, NVAR, double);
+    rhs0 = ARRAY_4D(NX3_MAX, NX2_MAX, NX1_MAX, NVAR, double);
+    for (m = 0; m < COMPONENTS; m++) vs[m] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    ps    = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    En    = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    R     = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    delta = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+  }
+
+/* --------------------------------------------------------
+   1. Shallow copy of d holding the current iterate of
+      velocity and pressure
+   -------------------------------------------------------- */
+
+  NVAR_LOOP(nv) Vc[nv] = d->Vc[nv];
+  for (m = 0; m < COMPONENTS; m++) Vc[VX1+m] = vs[m];
+  Vc[PRS] = ps;
+  ds.Vc   = Vc;
+
+  TOT_LOOP(k,j,i){
+    double rho = d->Vc[RHO][k][j][i], v2 = 0.0;
+    for (m = 0; m < COMPONENTS; m++){
+      vs[m][k][j][i] = d->Vc[VX1+m][k][j][i];
+      v2 += vs[m][k][j][i]*vs[m][k][j][i];
+    }
+    ps[k][j][i] = d->Vc[PRS][k][j][i];
+    En[k][j][i] = 0.5*rho*v2 + ps[k][j][i]/g1;
+  }
+
+  scale[0] = scale[1] = 1.e-30;
+  BOX_LOOP(box,k,j,i){
+    for (m = 0; m < COMPONENTS; m++){
+      scale[0] = MAX(scale[0], fabs(d->Vc[VX1+m][k][j][i]));
+    }
+    scale[1] = MAX(scale[1], d->Vc[PRS][k][j][i]/d->Vc[RHO][k][j][i]);
+  }
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, scale, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  #endif
+
+  if (PARABOLIC_MG_VISC) MGSetCoefficients (MG_VISC, d, th*dt, grid);
+
+/* --------------------------------------------------------
+   2. Defect correction: stop when the largest velocity and
+      temperature corrections, relative to max|v| and max(T)
+      at t^n, are below PARABOLIC_MG_TOL
+   -------------------------------------------------------- */
+
+  for (it = 0; ; it++){
+
+  /* -- 2a. Right hand side at the current iterate -- */
+
+    if (it > 0) Boundary (&ds, ALL_DIR, grid);
+    ParabolicRHS (&ds, rhs, box, NULL, PARABOLIC_MG_STEP, 1.0, grid);
+    if (it == 0) BOX_LOOP(box,k,j,i) NVAR_LOOP(nv) rhs0[k][j][i][nv] = rhs[k][j][i][nv];
+
+    if (it > 0){
+      #ifdef PARALLEL
+      MPI_Allreduce (MPI_IN_PLACE, cor, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      #endif
+      if (   cor[0] <= PARABOLIC_MG_TOL*scale[0]
+          && cor[1] <= PARABOLIC_MG_TOL*scale[1]) break;
+      if (it > PARABOLIC_MG_MAXIT){
+        printLog ("! ParabolicMGUpdate(): no convergence after %d iterations "
+                  "(corrections %8.2e, %8.2e)\n", it - 1, cor[0]/scale[0],
+                  cor[1]/scale[1]);
+        break;
+      }
+    }
+    cor[0] = cor[1] = 0.0;
+
+  /* -- 2b. Velocity corrections from the momentum residuals -- */
+
+    if (PARABOLIC_MG_VISC) for (m = 0; m < COMPONENTS; m++){
+      BOX_LOOP(box,k,j,i){
+        double L = (1.0 - th)*rhs0[k][j][i][MX1+m] + th*rhs[k][j][i][MX1+m];
+        R[k][j][i] =   d->Vc[RHO][k][j][i]*(d->Vc[VX1+m][k][j][i] - vs[m][k][j][i])
+                     + dt*L;
+      }
+      MGSolve (MG_VISC, R, delta);
+      BOX_LOOP(box,k,j,i){
+        vs[m][k][j][i] += delta[k][j][i];
+        cor[0] = MAX(cor[0], fabs(delta[k][j][i]));
+      }
+    }
+
+  /* -- 2c. Temperature correction from the energy residual -- */
+
+    if (PARABOLIC_MG_TC){
+      MGSetCoefficients (MG_TC, &ds, th*dt, grid);
+      BOX_LOOP(box,k,j,i){
+        double rho = d->Vc[RHO][k][j][i], v2 = 0.0, E;
+        for (m = 0; m < COMPONENTS; m++) v2 += vs[m][k][j][i]*vs[m][k][j][i];
+        E = En[k][j][i] + dt*((1.0 - th)*rhs0[k][j][i][ENG] + th*rhs[k][j][i][ENG]);
+        R[k][j][i] = E - 0.5*rho*v2 - ps[k][j][i]/g1;
+      }
+      MGSolve (MG_TC, R, delta);
+      BOX_LOOP(box,k,j,i){
+        ps[k][j][i] += d->Vc[RHO][k][j][i]*delta[k][j][i];
+        cor[1] = MAX(cor[1], fabs(delta[k][j][i]));
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+   3. Conservative increments (as rates), in flux form from
+      the right hand sides at t^n and at the last iterate
+   -------------------------------------------------------- */
+
+  BOX_LOOP(box,k,j,i){
+    for (m = 0; m < COMPONENTS; m++){
+      dU[MX1+m][k][j][i] =   (1.0 - th)*rhs0[k][j][i][MX1+m]
+                           + th*rhs[k][j][i][MX1+m];
+    }
+    dU[ENG][k][j][i] = (1.0 - th)*rhs0[k][j][i][ENG] + th*rhs[k][j][i][ENG];
+  }
+}
+
+/* ********************************************************************* */
+static void MGInit (Grid *grid)
+/*!
+ * Build the hierarchy of levels. Levels 0, .., nloc-1 halve the local
+ * block and are distributed as the grid; with more than one rank, level
+ * nloc is level nloc-1 gathered onto rank 0 (same resolution), and the
+ * coarser ones halve it on rank 0 alone (other ranks only keep their
+ * sizes).
+ *********************************************************************** */
+{
+  int    dir, nb[3][2];
+  MGLevel *a, *c;
+  #ifdef PARALLEL
+  int    l, r, m, incl[3] = {INCLUDE_IDIR, INCLUDE_JDIR, INCLUDE_KDIR};
+  long   nzones, ns, ng;
+  #endif
+
+  for (dir = 0; dir < 3; dir++){
+    periodic[dir] =    (dir < DIMENSIONS)
+                    && RuntimeGet()->left_bound[dir]  == PERIODIC
+                    && RuntimeGet()->right_bound[dir] == PERIODIC;
+  }
+  #ifdef PARALLEL
+  MPI_Comm_size (MPI_COMM_WORLD, &nrank);
+  #endif
+  MGNeighbours (nb, grid);
+
+/* --------------------------------------------------------
+   1. Distributed levels
+   -------------------------------------------------------- */
+
+  for (nloc = 0; ; ){
+    a = mg + nloc;
+    for (dir = 0; dir < 3; dir++){
+      a->nb[dir][0] = nb[dir][0];
+      a->nb[dir][1] = nb[dir][1];
+    }
+    MGLevelInit (a, nloc == 0 ? NULL : a - 1, 1, grid);
+    nloc++;
+    if (nloc == MG_MAX_LEVELS) break;
+
+    #ifdef PARALLEL
+    {
+      int halve = MGCanHalve (a);
+
+      nzones = 1;
+      for (dir = 0; dir < 3; dir++){
+        if (incl[dir]) nzones *= grid->np_int_glob[dir] >> (nloc - 1);
+      }
+      if (nrank > 1 && nzones <= MG_GATHER_ZONES) halve = 0;
+      MPI_Allreduce (MPI_IN_PLACE, &halve, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+      if (!halve) break;
+    }
+    #else
+    if (!MGCanHalve (a)) break;
+    #endif
+  }
+  nlev = nloc;
+
+/* --------------------------------------------------------
+   2. Gathered levels: offset and size of every block on
+      the last distributed level, gathered spacing, then
+      halve on rank 0
+   -------------------------------------------------------- */
+
+  #ifdef PARALLEL
+  if (nrank > 1 && nlev < MG_MAX_LEVELS){
+    int info[6];
+
+    a = mg + nloc - 1;
+    c = mg + nloc;
+    for (dir = 0; dir < 3; dir++){
+      info[dir]     = (incl[dir] ? (grid->beg[dir] - grid->nghost[dir]) >> (nloc - 1) : 0);
+      info[3 + dir] = a->n[dir];
+    }
+    blk = ARRAY_1D(6*nrank, int);
+    cnt = ARRAY_1D(nrank, int);
+    dsp = ARRAY_1D(nrank, int);
+    MPI_Allgather (info, 6, MPI_INT, blk, 6, MPI_INT, MPI_COMM_WORLD);
+
+    ns = (a->n[IDIR] + 1)*(a->n[JDIR] + 1)*(a->n[KDIR] + 1);
+    for (ng = 0, r = 0; r < nrank; r++){
+      ng += (blk[6*r + 3] + 1)*(blk[6*r + 4] + 1)*(blk[6*r + 5] + 1);
+    }
+    sbuf = ARRAY_1D(ns, double);
+    gbuf = ARRAY_1D(prank == 0 ? ng : 1, double);
+
+    for (dir = 0; dir < 3; dir++){
+      c->g[dir] = a->g[dir];
+      c->n[dir] = 1;
+      for (r = 0; r < nrank; r++){
+        c->n[dir] = MAX(c->n[dir], blk[6*r + dir] + blk[6*r + 3 + dir]);
+      }
+      c->nb[dir][0] = c->nb[dir][1] = (periodic[dir] ? prank : -1);
+      c->dx[dir]      = ARRAY_1D(c->n[dir] + 2, double);
+      c->inv_dxi[dir] = ARRAY_1D(c->n[dir] + 2, double);
+      c->dx[dir][0]   = 1.0;
+    }
+
+  /* -- Spacing of every block, in the i, j, k order -- */
+
+    for (m = 0, dir = 0; dir < 3; dir++){
+      if (incl[dir]) for (l = 1; l <= a->n[dir]; l++) sbuf[m++] = a->dx[dir][l];
+    }
+    for (r = 0; r < nrank; r++){
+      cnt[r] = 0;
+      for (dir = 0; dir < 3; dir++) if (incl[dir]) cnt[r] += blk[6*r + 3 + dir];
+      dsp[r] = (r == 0 ? 0 : dsp[r-1] + cnt[r-1]);
+    }
+    MPI_Gatherv (sbuf, m, MPI_DOUBLE, gbuf, cnt, dsp, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (prank == 0){
+      for (m = 0, r = 0; r < nrank; r++){
+        for (dir = 0; dir < 3; dir++){
+          if (!incl[dir]) continue;
+          for (l = 1; l <= blk[6*r + 3 + dir]; l++){
+            c->dx[dir][blk[6*r + dir] + l] = gbuf[m++];
+          }
+        }
+      }
+      MGSpacing (c, NULL);
+      MGLevelInit (c, c, 1, NULL);
+    }
+    nlev++;
+
+    while (nlev < MG_MAX_LEVELS && MGCanHalve (mg + nlev - 1)){
+      a = mg + nlev;
+      for (dir = 0; dir < 3; dir++){
+        a->nb[dir][0] = a->nb[dir][1] = (periodic[dir] ? prank : -1);
+      }
+      MGLevelInit (a, a - 1, prank == 0, NULL);
+      nlev++;
+    }
+  }
+  #endif
+
+  c = mg + nlev - 1;
+  printLog ("> ParabolicMGUpdate(): %d levels (%d distributed), "
+            "coarsest %d x %d x %d\n", nlev, nloc,
+            c->n[IDIR], c->n[JDIR], c->n[KDIR]);
+}
+
+/* ********************************************************************* */
+static void MGNeighbours (int nb[3][2], Grid *grid)
+/*!
+ * Rank of the left and right neighbours of the local block in every
+ * direction: -1 at physical boundaries, the local rank itself in
+ * periodic directions with a single block.
+ *********************************************************************** */
+{
+  int dir, side;
+  #ifdef PARALLEL
+  int r, d, c[3], *coord = ARRAY_1D(3*nrank, int);
+
+  MPI_Allgather (grid->rank_coord, 3, MPI_INT, coord, 3, MPI_INT,
+                 MPI_COMM_WORLD);
+  #endif
+
+  for (dir = 0; dir < 3; dir++) for (side = 0; side < 2; side++){
+    nb[dir][side] = (periodic[dir] ? prank : -1);
+    #ifdef PARALLEL
+    for (d = 0; d < 3; d++) c[d] = grid->rank_coord[d];
+    c[dir] += (side == 0 ? -1 : 1);
+    if (c[dir] < 0 || c[dir] >= grid->nproc[dir]){
+      if (!periodic[dir]) continue;
+      c[dir] = (c[dir] + grid->nproc[dir])%grid->nproc[dir];
+    }
+    for (r = 0; r < nrank; r++){
+      if (   coord[3*r] == c[0] && coord[3*r + 1] == c[1]
+          && coord[3*r + 2] == c[2]) nb[dir][side] = r;
+    }
+    #endif
+  }
+  #ifdef PARALLEL
+  FreeArray1D ((void *) coord);
+  #endif
+}
+
+/* ********************************************************************* */
+static void MGLevelInit (MGLevel *a, MGLevel *f, int alloc, Grid *grid)
+/*!
+ * Set the sizes of level a: the local block (f == NULL), the halved
+ * level f, or (f == a) a level whose spacing is already set. When
+ * alloc is 0 only the sizes are set.
+ *********************************************************************** */
+{
+  int l, dir, ne[3], np;
+  int beg[3] = {IBEG, JBEG, KBEG}, end[3] = {IEND, JEND, KEND};
+  int incl[3] = {INCLUDE_IDIR, INCLUDE_JDIR, INCLUDE_KDIR};
+
+  if (f != a) for (dir = 0; dir < 3; dir++){
+    a->g[dir] = incl[dir];
+    a->n[dir] = (f == NULL ? (incl[dir] ? end[dir] - beg[dir] + 1 : 1)
+                           : (incl[dir] ? f->n[dir]/2 : 1));
+    if (!alloc) continue;
+    a->dx[dir]      = ARRAY_1D(a->n[dir] + 2, double);
+    a->inv_dxi[dir] = ARRAY_1D(a->n[dir] + 2, double);
+    a->dx[dir][0]   = 1.0;
+    if (!incl[dir]) continue;
+    for (l = 1; l <= a->n[dir]; l++){
+      if (f == NULL) a->dx[dir][l] = grid->dx[dir][beg[dir] + l - 1];
+      else           a->dx[dir][l] = f->dx[dir][2*l-1] + f->dx[dir][2*l];
+    }
+  }
+  if (!alloc) return;
+  if (f != a) MGSpacing (a, f == NULL ? grid : NULL);
+
+/* -- Arrays and ghost exchange buffers (largest plane) -- */
+
+  #define MG_ARRAY  ARRAY_3D(ne[KDIR], ne[JDIR], ne[IDIR], double)
+  for (dir = 0; dir < 3; dir++) ne[dir] = a->n[dir] + 2*a->g[dir];
+  a->u = MG_ARRAY;
+  a->f = MG_ARRAY;
+  a->r = MG_ARRAY;
+  for (l = 0; l < MG_NSET; l++){
+    a->sig[l] = MG_ARRAY;
+    for (dir = 0; dir < 3; dir++) a->K[l][dir] = (incl[dir] ? MG_ARRAY : NULL);
+  }
+  #undef MG_ARRAY
+
+  np = MAX(ne[JDIR]*ne[KDIR], ne[IDIR]*ne[KDIR]);
+  np = MAX(np, ne[IDIR]*ne[JDIR]);
+  a->buf[0] = ARRAY_1D(np, double);
+  a->buf[1] = ARRAY_1D(np, double);
+}
+
+/* ********************************************************************* */
+static int MGCanHalve (MGLevel *a)
+/*!
+ * Return 1 when every active direction of level a can be halved.
+ *********************************************************************** */
+{
+  int dir;
+
+  for (dir = 0; dir < 3; dir++){
+    if (a->g[dir] && (a->n[dir]%2 != 0 || a->n[dir] < 4)) return 0;
+  }
+  return 1;
+}
+
+/* ********************************************************************* */
+static void MGSpacing (MGLevel *a, Grid *grid)
+/*!
+ * Ghost widths and inverse center distances of level a, from the
+ * interior widths. On the finest level (grid != NULL) ghost widths
+ * are the grid ones; otherwise they are taken from the neighbouring
+ * block, the periodic image or the adjacent zone.
+ *********************************************************************** */
+{
+  int    dir, l, L;
+  int    beg[3] = {IBEG, JBEG, KBEG}, end[3] = {IEND, JEND, KEND};
+  double *dx;
+
+  for (dir = 0; dir < 3; dir++){
+    if (!a->g[dir]) continue;
+    dx = a->dx[dir];
+    L  = a->n[dir];
+    if (grid != NULL){
+      dx[0]   = grid->dx[dir][beg[dir] - 1];
+      dx[L+1] = grid->dx[dir][end[dir] + 1];
+    }else{
+      dx[0]   = (periodic[dir] ? dx[L] : dx[1]);
+      dx[L+1] = (periodic[dir] ? dx[1] : dx[L]);
+      #ifdef PARALLEL
+      MPI_Sendrecv (dx + L, 1, MPI_DOUBLE, MG_PEER(a->nb[dir][1]), 0,
+                    dx,     1, MPI_DOUBLE, MG_PEER(a->nb[dir][0]), 0,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      MPI_Sendrecv (dx + 1,     1, MPI_DOUBLE, MG_PEER(a->nb[dir][0]), 1,
+                    dx + L + 1, 1, MPI_DOUBLE, MG_PEER(a->nb[dir][1]), 1,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      #endif
+    }
+    for (l = 1; l <= L + 1; l++) a->inv_dxi[dir][l] = 2.0/(dx[l-1] + dx[l]);
+  }
+}
+
+/* ********************************************************************* */
+static void MGSetCoefficients (int s, const Data *d, double thdt, Grid *grid)
+/*!
+ * Fill sigma and the face coefficients of set s on all levels, from
+ * the state in d (finest level) and by area/volume-weighted
+ * averaging (coarser levels).
+ *********************************************************************** */
+{
+  int    n, i, j, k, dir;
+  double g1 = g_gamma - 1.0;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
+  double coef = (s == MG_VISC ? dc->nu_visc : dc->kappa_tc);
+  double ***rho = d->Vc[RHO], ***prs = d->Vc[PRS];
+  MGLevel *a = mg, *f;
+
+/* --------------------------------------------------------
+   1. Finest level: cell (k,j,i) is zone
+      (KBEG + k - g, JBEG + j - g, IBEG + i - g)
+   -------------------------------------------------------- */
+
+  #define IX(l, dir)  ((dir == IDIR ? IBEG : (dir == JDIR ? JBEG : KBEG)) \
+                       + (l) - a->g[dir])
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+    double r0 = rho[IX(k,KDIR)][IX(j,JDIR)][IX(i,IDIR)];
+    a->sig[s][k][j][i] = (s == MG_VISC ? r0 : r0/g1);
+  }}}
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    int di = (dir == IDIR), dj = (dir == JDIR), dk = (dir == KDIR);
+    double *dx = grid->dx[dir];
+
+    for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR] + dk; k++){
+    for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR] + dj; j++){
+    for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR] + di; i++){
+      int kr = IX(k,KDIR), jr = IX(j,JDIR), ir = IX(i,IDIR);
+      int lr = (dir == IDIR ? ir : (dir == JDIR ? jr : kr));
+      double rl = rho[kr-dk][jr-dj][ir-di], rr = rho[kr][jr][ir];
+      double rf = (rl*dx[lr-1] + rr*dx[lr])/(dx[lr-1] + dx[lr]);
+      a->K[s][dir][k][j][i] = thdt*rf*coef;
+
+    /* -- Conduction: saturation factor, from the normal
+          temperature gradient only -- */
+
+      if (s == MG_TC){
+        double Tl = prs[kr-dk][jr-dj][ir-di]/rl, Tr = prs[kr][jr][ir]/rr;
+        double sqT  = sqrt(0.5*(Tl + Tr));
+        double Fmag = rf*coef*fabs(Tr - Tl)*grid->inv_dxi[dir][lr-1];
+        double Fsat = 5.0*dc->phi_tc*rf*sqT*sqT*sqT;
+
+        a->K[s][dir][k][j][i] *= Fsat/(Fsat + Fmag);
+      }
+    }}}
+  }
+  #undef IX
+
+/* --------------------------------------------------------
+   2. Coarser levels
+   -------------------------------------------------------- */
+
+  for (n = 1; n < nlev; n++){
+    a = mg + n;
+    f = mg + n - 1;
+
+    #ifdef PARALLEL
+    if (n == nloc){
+      MGGather (f->sig[s], a->sig[s], -1);
+      for (dir = 0; dir < DIMENSIONS; dir++){
+        MGGather (f->K[s][dir], a->K[s][dir], dir);
+      }
+      if (prank != 0) break;
+      continue;
+    }
+    #endif
+
+    for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+    for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+    for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+      int    ii, jj, kk, i0 = 2*i - a->g[IDIR], j0 = 2*j - a->g[JDIR];
+      int    k0 = 2*k - a->g[KDIR];
+      double sv = 0.0, V = 0.0, vf;
+
+      for (kk = k0; kk <= k0 + a->g[KDIR]; kk++){
+      for (jj = j0; jj <= j0 + a->g[JDIR]; jj++){
+      for (ii = i0; ii <= i0 + a->g[IDIR]; ii++){
+        vf  = f->dx[IDIR][ii]*f->dx[JDIR][jj]*f->dx[KDIR][kk];
+        sv += f->sig[s][kk][jj][ii]*vf;
+        V  += vf;
+      }}}
+      a->sig[s][k][j][i] = sv/V;
+    }}}
+
+    for (dir = 0; dir < DIMENSIONS; dir++){
+      int di = (dir == IDIR), dj = (dir == JDIR), dk = (dir == KDIR);
+
+      for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR] + dk; k++){
+      for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR] + dj; j++){
+      for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR] + di; i++){
+        int    ii, jj, kk;
+        int    i0 = 2*i - a->g[IDIR], j0 = 2*j - a->g[JDIR], k0 = 2*k - a->g[KDIR];
+        double sk = 0.0, A = 0.0, af;
+
+      /* -- Fine faces lying on the coarse face: the left faces
+            of the first children along dir -- */
+
+        for (kk = k0; kk <= k0 + a->g[KDIR]*(1 - dk); kk++){
+        for (jj = j0; jj <= j0 + a->g[JDIR]*(1 - dj); jj++){
+        for (ii = i0; ii <= i0 + a->g[IDIR]*(1 - di); ii++){
+          af  =   (di ? 1.0 : f->dx[IDIR][ii])*(dj ? 1.0 : f->dx[JDIR][jj])
+                 *(dk ? 1.0 : f->dx[KDIR][kk]);
+          sk += f->K[s][dir][kk][jj][ii]*af;
+          A  += af;
+        }}}
+        a->K[s][dir][k][j][i] = sk/A;
+      }}}
+    }
+  }
+}
+
+/* ********************************************************************* */
+static void MGSolve (int s, double ***R, double ***x)
+/*!
+ * Approximately solve sigma x - div(K grad x) = R (coefficient set s)
+ * on the local block with PARABOLIC_MG_CYCLES V-cycles, starting from
+ * x = 0. R and x are full-grid arrays indexed as d->Vc.
+ *********************************************************************** */
+{
+  int i, j, k, n;
+  MGLevel *a = mg;
+
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+    a->f[k][j][i] = R[KBEG + k - a->g[KDIR]][JBEG + j - a->g[JDIR]]
+                     [IBEG + i - a->g[IDIR]];
+    a->u[k][j][i] = 0.0;
+  }}}
+
+  for (n = 0; n < PARABOLIC_MG_CYCLES; n++) MGCycle (0, s);
+
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+    x[KBEG + k - a->g[KDIR]][JBEG + j - a->g[JDIR]][IBEG + i - a->g[IDIR]]
+       = a->u[k][j][i];
+  }}}
+}
+
+/* ********************************************************************* */
+static void MGCycle (int n, int s)
+/*!
+ * One V-cycle starting at level n.
+ *********************************************************************** */
+{
+  int    i, j, k, ii, jj, kk;
+  MGLevel *a = mg + n, *c;
+
+  if (n == nlev - 1){
+    MGSmooth (a, s, MG_NCOARSE);
+    return;
+  }
+  c = mg + n + 1;
+
+  MGSmooth (a, s, MG_NPRE);
+  MGResidual (a, s);
+
+/* -- Last distributed level: the correction is computed by
+      rank 0 on the gathered level (same resolution) -- */
+
+  #ifdef PARALLEL
+  if (n == nloc - 1){
+    MGGather (a->r, c->f, -1);
+    if (prank == 0){
+      for (k = c->g[KDIR]; k < c->n[KDIR] + c->g[KDIR]; k++){
+      for (j = c->g[JDIR]; j < c->n[JDIR] + c->g[JDIR]; j++){
+      for (i = c->g[IDIR]; i < c->n[IDIR] + c->g[IDIR]; i++){
+        c->u[k][j][i] = 0.0;
+      }}}
+      MGCycle (n + 1, s);
+    }
+    MGScatter (c->u, a->r);
+    for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+    for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+    for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+      a->u[k][j][i] += a->r[k][j][i];
+    }}}
+    MGSmooth (a, s, MG_NPOST);
+    return;
+  }
+  #endif
+
+/* -- Restriction (volume-weighted average) -- */
+
+  for (k = c->g[KDIR]; k < c->n[KDIR] + c->g[KDIR]; k++){
+  for (j = c->g[JDIR]; j < c->n[JDIR] + c->g[JDIR]; j++){
+  for (i = c->g[IDIR]; i < c->n[IDIR] + c->g[IDIR]; i++){
+    int    i0 = 2*i - c->g[IDIR], j0 = 2*j - c->g[JDIR], k0 = 2*k - c->g[KDIR];
+    double rv = 0.0, V = 0.0, vf;
+
+    for (kk = k0; kk <= k0 + c->g[KDIR]; kk++){
+    for (jj = j0; jj <= j0 + c->g[JDIR]; jj++){
+    for (ii = i0; ii <= i0 + c->g[IDIR]; ii++){
+      vf  = a->dx[IDIR][ii]*a->dx[JDIR][jj]*a->dx[KDIR][kk];
+      rv += a->r[kk][jj][ii]*vf;
+      V  += vf;
+    }}}
+    c->f[k][j][i] = rv/V;
+    c->u[k][j][i] = 0.0;
+  }}}
+
+  MGCycle (n + 1, s);
+
+/* -- Prolongation (piecewise constant) -- */
+
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+    a->u[k][j][i] += c->u[(k + c->g[KDIR])/2][(j + c->g[JDIR])/2]
+                         [(i + c->g[IDIR])/2];
+  }}}
+
+  MGSmooth (a, s, MG_NPOST);
+}
+
+/* ********************************************************************* */
+static void MGSmooth (MGLevel *a, int s, int nsweep)
+/*!
+ * Red-black Gauss-Seidel sweeps on level a.
+ *********************************************************************** */
+{
+  int n, color, k, j;
+
+  for (n = 0; n < nsweep; n++){
+    for (color = 0; color < 2; color++){
+      MGGhosts (a, a->u);
+
+      #ifdef _OPENMP
+      #pragma omp parallel for collapse(2) schedule(static)
+      #endif
+      for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+      for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+        int    i, i0 = a->g[IDIR] + (a->g[IDIR] + j + k + color)%2;
+        double diag, off;
+
+        if (!INCLUDE_IDIR) i0 = ((j + k + color)%2 == 0 ? 0 : 1);
+        for (i = i0; i < a->n[IDIR] + a->g[IDIR]; i += 2){
+          off = MGApply (a, s, a->u, k, j, i, &diag);
+          a->u[k][j][i] = (a->f[k][j][i] + off)/diag;
+        }
+      }}
+    }
+  }
+}
+
+/* ********************************************************************* */
+static void MGResidual (MGLevel *a, int s)
+/*!
+ * r = f - A u on level a.
+ *********************************************************************** */
+{
+  int k, j;
+
+  MGGhosts (a, a->u);
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) schedule(static)
+  #endif
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+    int    i;
+    double diag, off;
+
+    for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+      off = MGApply (a, s, a->u, k, j, i, &diag);
+      a->r[k][j][i] = a->f[k][j][i] - (diag*a->u[k][j][i] - off);
+    }
+  }}
+}
+
+/* ********************************************************************* */
+static double MGApply (MGLevel *a, int s, double ***u, int k, int j, int i,
+                       double *diag)
+/*!
+ * Split the operator at zone (k,j,i) as A u = diag*u[k][j][i] - off:
+ * return off and store diag.
+ *********************************************************************** */
+{
+  double kl, kr, off = 0.0, dg = a->sig[s][k][j][i];
+
+  #if INCLUDE_IDIR
+  kl  = a->K[s][IDIR][k][j][i]  *a->inv_dxi[IDIR][i]  /a->dx[IDIR][i];
+  kr  = a->K[s][IDIR][k][j][i+1]*a->inv_dxi[IDIR][i+1]/a->dx[IDIR][i];
+  dg  += kl + kr;
+  off += kl*u[k][j][i-1] + kr*u[k][j][i+1];
+  #endif
+  #if INCLUDE_JDIR
+  kl  = a->K[s][JDIR][k][j][i]  *a->inv_dxi[JDIR][j]  /a->dx[JDIR][j];
+  kr  = a->K[s][JDIR][k][j+1][i]*a->inv_dxi[JDIR][j+1]/a->dx[JDIR][j];
+  dg  += kl + kr;
+  off += kl*u[k][j-1][i] + kr*u[k][j+1][i];
+  #endif
+  #if INCLUDE_KDIR
+  kl  = a->K[s][KDIR][k][j][i]  *a->inv_dxi[KDIR][k]  /a->dx[KDIR][k];
+  kr  = a->K[s][KDIR][k+1][j][i]*a->inv_dxi[KDIR][k+1]/a->dx[KDIR][k];
+  dg  += kl + kr;
+  off += kl*u[k-1][j][i] + kr*u[k+1][j][i];
+  #endif
+
+  *diag = dg;
+  return off;
+}
+
+/* ********************************************************************* */
+static void MGGhosts (MGLevel *a, double ***q)
+/*!
+ * Fill the ghost zones of q: copies of the neighbouring block (of the
+ * block itself in periodic directions with a single block), zero at
+ * physical boundaries.
+ *********************************************************************** */
+{
+  int dir, L;
+  #ifdef PARALLEL
+  int np, nl, nr;
+  #endif
+
+  for (dir = 0; dir < 3; dir++){
+    if (!a->g[dir]) continue;
+    L = a->n[dir];
+    if (a->nb[dir][0] == prank){
+      MGPlane (a, q, dir, L, a->buf[0], 0);
+      MGPlane (a, q, dir, 0, a->buf[0], 1);
+      MGPlane (a, q, dir, 1, a->buf[0], 0);
+      MGPlane (a, q, dir, L + 1, a->buf[0], 1);
+      continue;
+    }
+
+    #ifdef PARALLEL
+    nl = MG_PEER(a->nb[dir][0]);
+    nr = MG_PEER(a->nb[dir][1]);
+    np = MGPlane (a, q, dir, L, a->buf[0], 0);
+    MPI_Sendrecv (a->buf[0], np, MPI_DOUBLE, nr, 2*dir,
+                  a->buf[1], np, MPI_DOUBLE, nl, 2*dir,
+                  MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MGPlane (a, q, dir, 0, nl == MPI_PROC_NULL ? NULL : a->buf[1], 1);
+
+    MGPlane (a, q, dir, 1, a->buf[0], 0);
+    MPI_Sendrecv (a->buf[0], np, MPI_DOUBLE, nl, 2*dir + 1,
+                  a->buf[1], np, MPI_DOUBLE, nr, 2*dir + 1,
+                  MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MGPlane (a, q, dir, L + 1, nr == MPI_PROC_NULL ? NULL : a->buf[1], 1);
+    #else
+    MGPlane (a, q, dir, 0, NULL, 1);
+    MGPlane (a, q, dir, L + 1, NULL, 1);
+    #endif
+  }
+}
+
+/* ********************************************************************* */
+static int MGPlane (MGLevel *a, double ***q, int dir, int l, double *buf,
+                    int unpack)
+/*!
+ * Copy the plane l normal to dir of q (ghost zones of the other
+ * directions included) to buf, or buf to the plane when unpack is 1
+ * (zero when buf is NULL).
+ *
+ * \return the number of zones in the plane.
+ *********************************************************************** */
+{
+  int i, j, k, m = 0, lo[3] = {0, 0, 0}, hi[3];
+
+  for (i = 0; i < 3; i++) hi[i] = a->n[i] + 2*a->g[i] - 1;
+  lo[dir] = hi[dir] = l;
+
+  for (k = lo[KDIR]; k <= hi[KDIR]; k++){
+  for (j = lo[JDIR]; j <= hi[JDIR]; j++){
+  for (i = lo[IDIR]; i <= hi[IDIR]; i++){
+    if (!unpack)         buf[m] = q[k][j][i];
+    else if (buf == NULL) q[k][j][i] = 0.0;
+    else                 q[k][j][i] = buf[m];
+    m++;
+  }}}
+  return m;
+}
+
+#ifdef PARALLEL
+/* ********************************************************************* */
+static void MGCounts (const int *e)
+/*!
+ * Counts and displacements of the blocks of the last distributed
+ * level, with e[dir] extra faces along dir.
+ *********************************************************************** */
+{
+  int r, *n;
+
+  for (r = 0; r < nrank; r++){
+    n      = blk + 6*r + 3;
+    cnt[r] = (n[IDIR] + e[IDIR])*(n[JDIR] + e[JDIR])*(n[KDIR] + e[KDIR]);
+    dsp[r] = (r == 0 ? 0 : dsp[r-1] + cnt[r-1]);
+  }
+}
+
+/* ********************************************************************* */
+static void MGGather (double ***q, double ***qc, int fdir)
+/*!
+ * Gather q of the last distributed level (zones, or faces normal to
+ * fdir when fdir >= 0) into qc of the gathered level on rank 0.
+ *********************************************************************** */
+{
+  int i, j, k, r, m = 0, e[3] = {0, 0, 0}, *off, *n;
+  MGLevel *a = mg + nloc - 1;
+
+  if (fdir >= 0) e[fdir] = 1;
+  for (k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR] + e[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR] + e[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR] + e[IDIR]; i++){
+    sbuf[m++] = q[k][j][i];
+  }}}
+  MGCounts (e);
+  MPI_Gatherv (sbuf, m, MPI_DOUBLE, gbuf, cnt, dsp, MPI_DOUBLE, 0,
+               MPI_COMM_WORLD);
+  if (prank != 0) return;
+
+/* -- Blocks share their boundary faces: the copies are equal -- */
+
+  for (m = 0, r = 0; r < nrank; r++){
+    off = blk + 6*r;
+    n   = blk + 6*r + 3;
+    for (k = a->g[KDIR]; k < n[KDIR] + a->g[KDIR] + e[KDIR]; k++){
+    for (j = a->g[JDIR]; j < n[JDIR] + a->g[JDIR] + e[JDIR]; j++){
+    for (i = a->g[IDIR]; i < n[IDIR] + a->g[IDIR] + e[IDIR]; i++){
+      qc[k + off[KDIR]][j + off[JDIR]][i + off[IDIR]] = gbuf[m++];
+    }}}
+  }
+}
+
+/* ********************************************************************* */
+static void MGScatter (double ***qc, double ***q)
+/*!
+ * Scatter the zones of qc on the gathered level of rank 0 to q on the
+ * last distributed level.
+ *********************************************************************** */
+{
+  int i, j, k, r, m = 0, e[3] = {0, 0, 0}, *off, *n;
+  MGLevel *a = mg + nloc - 1;
+
+  MGCounts (e);
+  if (prank == 0) for (r = 0; r < nrank; r++){
+    off = blk + 6*r;
+    n   = blk + 6*r + 3;
+    for (k = a->g[KDIR]; k < n[KDIR] + a->g[KDIR]; k++){
+    for (j = a->g[JDIR]; j < n[JDIR] + a->g[JDIR]; j++){
+    for (i = a->g[IDIR]; i < n[IDIR] + a->g[IDIR]; i++){
+      gbuf[m++] = qc[k + off[KDIR]][j + off[JDIR]][i + off[IDIR]];
+    }}}
+  }
+  m = cnt[prank];
+  MPI_Scatterv (gbuf, cnt, dsp, MPI_DOUBLE, sbuf, m, MPI_DOUBLE, 0,
+                MPI_COMM_WORLD);
+
+  for (m = 0, k = a->g[KDIR]; k < a->n[KDIR] + a->g[KDIR]; k++){
+  for (j = a->g[JDIR]; j < a->n[JDIR] + a->g[JDIR]; j++){
+  for (i = a->g[IDIR]; i < a->n[IDIR] + a->g[IDIR]; i++){
+    q[k][j][i] = sbuf[m++];
+  }}}
+}
+#endif
+
+#endif /* PARABOLIC_MG_ON == YES */
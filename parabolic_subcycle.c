@@ -0,0 +1,180 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Explicit subcycling of the diffusion operators.
+
+  When ::PARABOLIC_SUBCYCLE is set to YES, the explicit diffusion
+  operators (viscosity, thermal conduction and tracer diffusion
+  declared EXPLICIT, unless handled by parabolic_mg.c) are removed
+  from the Runge-Kutta stages and advanced at the beginning of the
+  step, with density fixed, by N forward Euler substeps
+  \f[
+    U^{m+1} = U^m + \Delta\tau\,\vec{L}(U^m)\,,\qquad
+    \Delta\tau \le \frac{C_p}{2\Delta t_p^{-1}}
+  \f]
+  where \f$C_p\f$ is the parabolic Courant number (\c CFL_par) and
+  \f$\Delta t_p^{-1}\f$ is the inverse diffusion time step returned by
+  ParabolicRHS() at the current substep.
+  Their inverse time step no longer enters \c Dts->invDt_par, so the
+  global step is set by the hyperbolic CFL condition alone: when
+  diffusion is the more restrictive, the operators take several
+  stable substeps inside one hydro step (N = 1 otherwise).
+  Every substep divides the time left into the fewest equal parts
+  allowed by the current limit and takes the first one; since the
+  limit is recomputed after every substep, diffusivities depending on
+  the state (e.g. conduction) stay within their stability limit, and
+  the substeps have equal size only while the limit does not change.
+  With ::PARABOLIC_TIMERS the number of substeps is written to the
+  log file together with the timers.
+
+  As in tracer_sts.c, every substep evaluates the right hand side with
+  ParabolicRHS() on a shallow copy of the data structure whose
+  velocity, pressure and tracer arrays hold the substep state,
+  followed by a call to Boundary() on the copy.
+  The increments of momentum, energy and \f$\rho C\f$ are returned as
+  rates and added by ParabolicUpdate() to every stage, as for the
+  other split operators.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if PARABOLIC_SUBCYCLE_ON == YES
+
+#define SUBCYCLE_MAX_STEPS  4096
+
+/* ********************************************************************* */
+void ParabolicSubcycle (const Data *d, double ****dU, RBox *box,
+                        double dt, Grid *grid)
+/*!
+ * Advance the subcycled diffusion operators over dt and store the
+ * conservative increments divided by dt.
+ *
+ * \param [in]  d      pointer to PLUTO Data structure (state at t^n,
+ *                     boundaries already assigned)
+ * \param [out] dU     the rate dU[nv][k][j][i] = Delta(U_nv)/dt for
+ *                     the components changed by the subcycled
+ *                     operators; other components are left untouched.
+ * \param [in]  box    box defining the zones to be updated
+ * \param [in]  dt     the time step
+ * \param [in]  grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, m, nv, nsub, nleft;
+  double g1 = g_gamma - 1.0;
+  double t, tau, invDt;
+  static double ****rhs, ***vs[COMPONENTS], ***ps, ***cs[NTRACER];
+  double ***Vc[NVAR];
+  Data   ds = *d;
+
+  if (rhs == NULL){
+    rhs = ARRAY_4D(NX3_MAX, NX2_MAX, NX1_MAX, NVAR, double);
+    for (m = 0; m < COMPONENTS; m++) vs[m] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    ps = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+    for (m = 0; m < NTRACER; m++) cs[m] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+  }
+
+/* --------------------------------------------------------
+   1. Shallow copy of d holding the substep state
+   -------------------------------------------------------- */
+
+  NVAR_LOOP(nv) Vc[nv] = d->Vc[nv];
+  #if PARABOLIC_SUB_VISC || PARABOLIC_SUB_TC
+  for (m = 0; m < COMPONENTS; m++) Vc[VX1+m] = vs[m];
+  Vc[PRS] = ps;
+  TOT_LOOP(k,j,i){
+    for (m = 0; m < COMPONENTS; m++) vs[m][k][j][i] = d->Vc[VX1+m][k][j][i];
+    ps[k][j][i] = d->Vc[PRS][k][j][i];
+  }
+  #endif
+  #if PARABOLIC_SUB_TRC
+  for (m = 0; m < NTRACER; m++){
+    Vc[TRC+m] = cs[m];
+    TOT_LOOP(k,j,i) cs[m][k][j][i] = d->Vc[TRC+m][k][j][i];
+  }
+  #endif
+  ds.Vc = Vc;
+
+/* --------------------------------------------------------
+   2. Forward Euler substeps
+   -------------------------------------------------------- */
+
+  t    = 0.0;
+  nsub = 0;
+  while (t < dt){
+    if (nsub > 0) Boundary (&ds, ALL_DIR, grid);
+    invDt = ParabolicRHS (&ds, rhs, box, NULL, PARABOLIC_SUB_STEP, 1.0, grid);
+
+  /* -- Time left split in equal parts within the current limit -- */
+
+    nleft = 1;
+    if (invDt > 0.0){
+      nleft = (int)ceil((dt - t)*2.0*invDt/RuntimeGet()->cfl_par);
+      nleft = MAX(nleft, 1);
+    }
+    tau = (dt - t)/(double)nleft;
+    if (nsub + nleft > SUBCYCLE_MAX_STEPS){
+      printLog ("! ParabolicSubcycle(): too many substeps (%d)\n", nsub + nleft);
+      QUIT_PLUTO(1);
+    }
+
+    BOX_LOOP(box,k,j,i){
+      double rho = d->Vc[RHO][k][j][i];
+
+      #if PARABOLIC_SUB_VISC || PARABOLIC_SUB_TC
+      double v2 = 0.0, E;
+
+      for (m = 0; m < COMPONENTS; m++) v2 += vs[m][k][j][i]*vs[m][k][j][i];
+      E = 0.5*rho*v2 + ps[k][j][i]/g1 + tau*rhs[k][j][i][ENG];
+      v2 = 0.0;
+      for (m = 0; m < COMPONENTS; m++){
+        vs[m][k][j][i] += tau*rhs[k][j][i][MX1+m]/rho;
+        v2 += vs[m][k][j][i]*vs[m][k][j][i];
+      }
+      ps[k][j][i] = g1*(E - 0.5*rho*v2);
+      #endif
+      #if PARABOLIC_SUB_TRC
+      for (m = 0; m < NTRACER; m++) cs[m][k][j][i] += tau*rhs[k][j][i][TRC+m]/rho;
+      #endif
+    }
+    t = (nleft == 1 ? dt : t + tau);
+    nsub++;
+  }
+
+  #if PARABOLIC_TIMERS == YES
+  if (RuntimeGet()->log_freq > 0 && g_stepNumber%RuntimeGet()->log_freq == 0){
+    printLog ("> ParabolicSubcycle(): %d substep(s)\n", nsub);
+  }
+  #endif
+
+/* --------------------------------------------------------
+   3. Conservative increments (as rates)
+   -------------------------------------------------------- */
+
+  BOX_LOOP(box,k,j,i){
+    double rho = d->Vc[RHO][k][j][i];
+
+    #if PARABOLIC_SUB_VISC || PARABOLIC_SUB_TC
+    double v2 = 0.0, w2 = 0.0;
+
+    for (m = 0; m < COMPONENTS; m++){
+      v2 += vs[m][k][j][i]*vs[m][k][j][i];
+      w2 += d->Vc[VX1+m][k][j][i]*d->Vc[VX1+m][k][j][i];
+      #if PARABOLIC_SUB_VISC
+      dU[MX1+m][k][j][i] = rho*(vs[m][k][j][i] - d->Vc[VX1+m][k][j][i])/dt;
+      #endif
+    }
+    dU[ENG][k][j][i] = (  0.5*rho*(v2 - w2)
+                        + (ps[k][j][i] - d->Vc[PRS][k][j][i])/g1)/dt;
+    #endif
+    #if PARABOLIC_SUB_TRC
+    for (m = 0; m < NTRACER; m++){
+      dU[TRC+m][k][j][i] = rho*(cs[m][k][j][i] - d->Vc[TRC+m][k][j][i])/dt;
+    }
+    #endif
+  }
+}
+
+#endif /* PARABOLIC_SUBCYCLE_ON == YES */
@@ -0,0 +1,190 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Wall-clock timers for the parabolic step.
+
+  When ::PARABOLIC_TIMERS is set to YES, ParabolicUpdate() and
+  ParabolicRHS() time each diffusion kernel (tracer, fused, thermal
+  conduction, viscosity), each sweep direction, the operator-split
+  stage and the final accumulation loop.
+  For every timer the elapsed time, the number of calls and the number
+  of zones processed are recorded.
+
+  Records are kept per thread, so that the pencil kernels can be timed
+  inside OpenMP parallel regions without synchronization; times of
+  kernels running in parallel are therefore summed over threads.
+  Every \c log steps the counters of the last interval are written to
+  the (per-rank) log file and added to the run totals, which are
+  summarised once at exit.
+
+  With ::PARABOLIC_TIMERS set to NO (default) the timer macros expand
+  to nothing.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if PARABOLIC_TIMERS == YES
+
+#ifdef _OPENMP
+ #include <omp.h>
+#else
+ #include <time.h>
+#endif
+
+typedef struct PTimerRec_{
+  double time[PT_COUNT];
+  long   calls[PT_COUNT];
+  long   cells[PT_COUNT];
+  char   pad[64];            /* Keep records of different threads apart */
+} PTimerRec;
+
+static const char *ptimer_name[PT_COUNT] = {
+  "RHS (total)", "X1-sweep", "X2-sweep", "X3-sweep", "tiled sweep",
+  "TRACER_RHS", "fused", "TC_RHS", "ViscousRHS", "split stage",
+  "update loop"};
+
+static PTimerRec *ptimer;    /* Interval counters, one per thread */
+static PTimerRec  ptotal;    /* Run totals */
+static int   nthreads, paused;
+static long  first_step;
+
+static void ParabolicTimersSummary (void);
+static void ParabolicTimersPrint (PTimerRec *);
+
+/* ********************************************************************* */
+void ParabolicTimersInit (void)
+/*!
+ * Allocate the per-thread records. Must be called outside parallel
+ * regions; calls after the first one do nothing.
+ *********************************************************************** */
+{
+  if (ptimer != NULL) return;
+
+  #ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+  #else
+  nthreads = 1;
+  #endif
+  ptimer = (PTimerRec *) calloc(nthreads, sizeof(PTimerRec));
+  first_step = g_stepNumber;
+  atexit (ParabolicTimersSummary);
+}
+
+/* ********************************************************************* */
+double ParabolicTimerNow (void)
+/*!
+ * Return the wall-clock time in seconds.
+ *********************************************************************** */
+{
+  #ifdef _OPENMP
+  return omp_get_wtime();
+  #else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1.e-9*ts.tv_nsec;
+  #endif
+}
+
+/* ********************************************************************* */
+void ParabolicTimerAdd (int id, double t0, long cells)
+/*!
+ * Charge the time elapsed since t0 and the number of zones processed
+ * to timer id of the calling thread.
+ *
+ * \param [in] id      the timer label (PT_RHS, PT_TRACER, ...)
+ * \param [in] t0      start time, as returned by ParabolicTimerNow()
+ * \param [in] cells   number of zones processed
+ *********************************************************************** */
+{
+  int tid = 0;
+  PTimerRec *r;
+
+  if (ptimer == NULL || paused) return;
+  #ifdef _OPENMP
+  tid = omp_get_thread_num();
+  if (tid >= nthreads) return;
+  #endif
+  r = ptimer + tid;
+  r->time[id]  += ParabolicTimerNow() - t0;
+  r->calls[id] += 1;
+  r->cells[id] += cells;
+}
+
+/* ********************************************************************* */
+void ParabolicTimersPause (int pause)
+/*!
+ * Stop (pause = 1) or resume (pause = 0) charging the timers, e.g.
+ * while ParabolicBench() calls the kernels outside the time step.
+ * Must be called outside parallel regions.
+ *********************************************************************** */
+{
+  paused = pause;
+}
+
+/* ********************************************************************* */
+void ParabolicTimersLog (void)
+/*!
+ * Write the counters accumulated since the last call to the log file,
+ * add them to the run totals and reset them.
+ *********************************************************************** */
+{
+  int n, id;
+  PTimerRec sum;
+
+  if (ptimer == NULL) return;
+
+  memset (&sum, 0, sizeof(sum));
+  for (n = 0; n < nthreads; n++){
+    for (id = 0; id < PT_COUNT; id++){
+      sum.time[id]  += ptimer[n].time[id];
+      sum.calls[id] += ptimer[n].calls[id];
+      sum.cells[id] += ptimer[n].cells[id];
+    }
+  }
+  memset (ptimer, 0, nthreads*sizeof(PTimerRec));
+
+  for (id = 0; id < PT_COUNT; id++){
+    ptotal.time[id]  += sum.time[id];
+    ptotal.calls[id] += sum.calls[id];
+    ptotal.cells[id] += sum.cells[id];
+  }
+
+  printLog ("> Parabolic timers, step %ld:\n", g_stepNumber);
+  ParabolicTimersPrint (&sum);
+}
+
+/* ********************************************************************* */
+static void ParabolicTimersSummary (void)
+/*!
+ * Write the run totals to the log file (registered with atexit()).
+ *********************************************************************** */
+{
+  ParabolicTimersLog ();
+  printLog ("> Parabolic timers, totals over steps %ld - %ld:\n",
+            first_step, g_stepNumber);
+  ParabolicTimersPrint (&ptotal);
+}
+
+/* ********************************************************************* */
+static void ParabolicTimersPrint (PTimerRec *r)
+/*!
+ * Print one line per timer with non-zero calls.
+ *********************************************************************** */
+{
+  int id;
+
+  for (id = 0; id < PT_COUNT; id++){
+    if (r->calls[id] == 0) continue;
+    printLog ("  %-12s %11.4e s  %9ld calls  %12ld zones",
+              ptimer_name[id], r->time[id], r->calls[id], r->cells[id]);
+    if (r->cells[id] > 0){
+      printLog ("  %8.2f ns/zone", 1.e9*r->time[id]/r->cells[id]);
+    }
+    printLog ("\n");
+  }
+}
+
+#endif /* PARABOLIC_TIMERS == YES */
@@ -96,8 +96,20 @@
 #include "local_pluto.h"
 #if PARABOLIC_FLUX != NO
 
+#ifdef _OPENMP
+ #include <omp.h>
+ #define THREAD_ID  omp_get_thread_num()
+#else
+ #define THREAD_ID  0
+#endif
+
 #define MAX_OP   (8+NTRACER)   /* Maximum number of diffusion operators */
 
+#if (PARABOLIC_SPLIT == YES) && !(PARABOLIC_FLUX & EXPLICIT)
+  #error Split diffusion stages are driven by ParabolicUpdate(): \
+         at least one other operator must be EXPLICIT
+#endif
+
 /* Define diffusion operator labels, in increasing order */
 enum PARABOLIC_OPERATORS{
   AMB_DIFF_OP,      /* AMBIPOLAR DIFFUSION */
@@ -108,6 +120,49 @@ enum PARABOLIC_OPERATORS{
   TRACER_OP,          /* Tracer diffusion */
 };
 
+/* With PARABOLIC_DT_STREAM_ON, the inverse time step of these operators
+   is reduced tile by tile instead of being stored on the full grid. */
+#define STREAM_OP(n)  ((PARABOLIC_DT_STREAM_ON == YES) && \
+                       ((n) >= TRACER_OP || ((PARABOLIC_FUSED_ON == YES) \
+                        && ((n) == TC_OP || (n) == VISC_OP))))
+
+/* Operators whose inverse time step follows from the grid spacing
+   alone (spatially constant tracer diffusivities on Cartesian grids,
+   see TracerInvDtConst()) instead of being accumulated zone by zone.
+   Not with the activity mask, whose inactive tiles do not enter the
+   time step. */
+#define CONST_DT_OP(n)  ((n) >= TRACER_OP && (GEOMETRY == CARTESIAN) && \
+                         (TRACER_ACTIVE_MASK_ON == NO) && \
+                         DiffusionConstantsGet()->trc_const)
+
+#if PARABOLIC_DT_STREAM_ON == NO
+static double PencilSweep (const Data *, Data_Arr, RBox *, double **,
+                           double, int *, double ****, Grid *);
+#endif
+static void   TracerInvDtConst (RBox *, int *, double *, double *, Grid *);
+#if PARABOLIC_DT_STREAM_ON == YES
+static void   TiledPencilSweep (const Data *, Data_Arr, RBox *, double **,
+                                double, int *, int *, double *, double *,
+                                Grid *);
+#endif
+static void   PencilRHS (const Data *, Data_Arr, ParabolicWork *, int *,
+                         double **, double, int, int, Grid *);
+static double PencilInvDt (ParabolicWork *, int *, double ****, int *,
+                           int, int, Grid *);
+#if PARABOLIC_FUSED_ON == YES
+static double FaceInvDt (double ***, double *, double *, int *, int, int,
+                         int, int);
+#endif
+static int    PencilBatch (int, int *);
+static int    RHSVars (int *, int *);
+#if PARABOLIC_SPLIT == YES
+static int    SplitVars (int *);
+#endif
+
+/* Set by ParabolicUpdate() while ParabolicRHS() accumulates into the
+   caller's dU (PARABOLIC_RHS_STREAM_ON): the sweeps must not clear it. */
+static int rhs_accumulate = 0;
+
 /* ********************************************************************* */
 void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
                      double dt, timeStep *Dts, Grid *grid)
@@ -137,26 +192,70 @@ void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
  * \param [in]     grid     Pointer to the grid structure
  *********************************************************************** */
 {
+  #if (PARABOLIC_RHS_STREAM_ON == NO) || (PARABOLIC_SPLIT == YES)
   int    i,j,k,nv;
-  int    beg_dir, end_dir;
+  #endif
+  double invDt_par;
+  static int    first = 1;
+  #if PARABOLIC_RHS_STREAM_ON == NO
   static unsigned char ***flag; 
-  double invDt_par, *u;
   static double ****rhs;
+  #endif
+  #if PARABOLIC_SPLIT == YES
+  static double ***split_rhs[NVAR];   /* Planes, NULL when unused */
+  static int    split_var[NVAR], nsplit, n;
+  #endif
   
 /* --------------------------------------------------------
-   0. Allocate memory
+   0. Return at once when diffusion has been switched off
+      at runtime (DIFFUSION = 0 in pluto.ini); allocate
+      memory otherwise.
    -------------------------------------------------------- */
 
-  if (rhs == NULL){
+  DiffusionConstantsUpdate ();
+  if (!DiffusionConstantsGet()->on) return;
+
+  if (first){
+    #if PARABOLIC_TIMERS == YES
+    ParabolicTimersInit ();
+    #endif
+    #if PARABOLIC_RHS_STREAM_ON == NO
     rhs = ARRAY_4D(NX3_MAX, NX2_MAX, NX1_MAX, NVAR, double);
+    TOT_LOOP(k,j,i) NVAR_LOOP(nv) rhs[k][j][i][nv] = 0.0;  /* See RHSVars() */
+    #endif
+    #if PARABOLIC_SPLIT == YES
+    nsplit = SplitVars (split_var);
+    for (n = 0; n < nsplit; n++){
+      nv = split_var[n];
+      split_rhs[nv] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+      TOT_LOOP(k,j,i) split_rhs[nv][k][j][i] = 0.0;
+    }
+    #endif
+    first = 0;
   }
 
 /* --------------------------------------------------------
-   1. Compute parabolic RHS when is d is not a NULL pointer
+   1. Compute parabolic RHS when is d is not a NULL pointer.
+      With PARABOLIC_RHS_STREAM_ON, the increments (already
+      multiplied by dt) are added to dU by the sweeps
+      themselves, and step 2 only adds the split rates.
    -------------------------------------------------------- */
 
+  #if PARABOLIC_TIMERS == YES
+  if (g_intStage == 1 && RuntimeGet()->log_freq > 0
+                      && g_stepNumber%RuntimeGet()->log_freq == 0){
+    ParabolicTimersLog ();
+  }
+  #endif
+
   if (d != NULL){
+    #if PARABOLIC_RHS_STREAM_ON == YES
+    rhs_accumulate = 1;
+    invDt_par = ParabolicRHS(d, dU, domBox, aflux, EXPLICIT, dt, grid);
+    rhs_accumulate = 0;
+    #else
     invDt_par = ParabolicRHS(d, rhs, domBox, aflux, EXPLICIT,  1.0, grid);
+    #endif
 
     if (g_intStage == 1){
       #ifdef  CTU
@@ -166,7 +265,37 @@ void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       Dts->invDt_par = MAX(Dts->invDt_par, invDt_par);
       #endif
     }
+    #if PARABOLIC_RHS_STREAM_ON == NO
     flag = d->flag;  /* Take the address of d->flag for later re-use */
+    #endif
+
+  /* -- Operator-split diffusion (tracer STS/RKL, ADI, spectral,
+        implicit or subcycled viscosity and conduction):
+        increment over the whole step, applied as a constant rate
+        during every stage -- */
+
+    #if PARABOLIC_SPLIT == YES
+    if (g_intStage == 1){
+      PTIMER_START(t0);
+      #if (TRACER_DIFFUSION == SUPER_TIME_STEPPING) || \
+          (TRACER_DIFFUSION == RK_LEGENDRE)
+      TracerSplitUpdate (d, split_rhs, domBox, dt, grid);
+      #endif
+      #if TRACER_DIFFUSION == ADI
+      TracerADIUpdate (d, split_rhs, domBox, dt, grid);
+      #endif
+      #if (TRACER_DIFFUSION == SPECTRAL) || (SPECTRAL_VISCOSITY == YES)
+      SpectralDiffusion (d, split_rhs, domBox, dt, grid);
+      #endif
+      #if PARABOLIC_MG_ON == YES
+      ParabolicMGUpdate (d, split_rhs, domBox, dt, grid);
+      #endif
+      #if PARABOLIC_SUBCYCLE_ON == YES
+      ParabolicSubcycle (d, split_rhs, domBox, dt, grid);
+      #endif
+      PTIMER_STOP(PT_SPLIT, t0, RBOX_ZONES(domBox));
+    }
+    #endif
   }
 
 /* --------------------------------------------------------
@@ -174,6 +303,15 @@ void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       variables.
    -------------------------------------------------------- */
 
+  PTIMER_START(t_update);
+  #if (PARABOLIC_RHS_STREAM_ON == YES) && (PARABOLIC_SPLIT == YES)
+  for (n = 0; n < nsplit; n++){
+    double ***S = split_rhs[split_var[n]];
+
+    nv = split_var[n];
+    BOX_LOOP(domBox, k,j,i) dU[k][j][i][nv] += dt*S[k][j][i];
+  }
+  #elif PARABOLIC_RHS_STREAM_ON == NO
   BOX_LOOP(domBox, k,j,i){
 
     #if VISCOSITY == EXPLICIT
@@ -181,6 +319,15 @@ void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
     dU[k][j][i][MX2] += dt*rhs[k][j][i][MX2];
     dU[k][j][i][MX3] += dt*rhs[k][j][i][MX3];
     #endif
+    #if TRACER_DIFFUSION == EXPLICIT
+    NTRACER_LOOP(nv) dU[k][j][i][nv] += dt*rhs[k][j][i][nv];
+    #endif
+    #if PARABOLIC_SPLIT == YES
+    for (n = 0; n < nsplit; n++){
+      nv = split_var[n];
+      dU[k][j][i][nv] += dt*split_rhs[nv][k][j][i];
+    }
+    #endif
     #if (AMBIPOLAR_DIFFUSION == EXPLICIT) || (RESISTIVITY == EXPLICIT)
     dU[k][j][i][BX1] += dt*rhs[k][j][i][BX1];
     dU[k][j][i][BX2] += dt*rhs[k][j][i][BX2];
@@ -221,7 +368,8 @@ void ParabolicUpdate(const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
     }
     #endif
   } /* End BOX_LOOP() */
-
+  #endif
+  PTIMER_STOP(PT_UPDATE, t_update, RBOX_ZONES(domBox));
 }
 
 /* ********************************************************************* */
@@ -243,11 +391,20 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
  *********************************************************************** */
 {
   int     i, j, k, nv;
-  int     nbeg, nend;
-  int     includeDir[3], include[8];
-  double  scrh;
+  #if RESISTIVITY || (PARABOLIC_FUSED_ON == NO)
+  int     nbeg, nend;    /* Serial operators (not pencil-parallel) */
+  #endif
+  int     includeDir[3], include[MAX_OP];
+  int     accum = (g_intStage == 1), accum_trc;
+  double  scrh, max_invDt_cell = 0.0;
   double  max_invDt_par = 0.0, invDt_par;
-  static  double ***C_dtp[MAX_OP], *dcoeff, **dcoeff_res;
+  static  double ***C_dtp[MAX_OP], *dcoeff;
+  #if RESISTIVITY
+  static  double **dcoeff_res;
+  #endif
+  PTIMER_START(t_rhs);
+
+  DiffusionConstantsUpdate ();
   
 /* --------------------------------------------------------
    0. Allocate storage memory for sweep structure,
@@ -259,8 +416,14 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
    -------------------------------------------------------- */
 
   if (dcoeff == NULL) {
+    #if PARABOLIC_TIMERS == YES
+    ParabolicTimersInit ();
+    #endif
     dcoeff  = ARRAY_1D(NMAX_POINT, double);
+    #if RESISTIVITY
     dcoeff_res  = ARRAY_2D(3, NMAX_POINT, double);
+    #endif
+    GetParabolicWork (0);   /* Allocate thread workspaces (serially) */
 
     if (AMBIPOLAR_DIFFUSION) {
       C_dtp[AMB_DIFF_OP] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
@@ -273,20 +436,23 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       C_dtp[RES_OP+1] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
       C_dtp[RES_OP+2] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
     }  
-    if (THERMAL_CONDUCTION){
+    if (THERMAL_CONDUCTION && !STREAM_OP(TC_OP)){
       C_dtp[TC_OP] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
     }
-    if (VISCOSITY){
+    if (VISCOSITY && !STREAM_OP(VISC_OP)){
       C_dtp[VISC_OP] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
     }
   }
   for (i = TRACER_OP; i < TRACER_OP+NTRACER; i++){
-    if (C_dtp[i] == NULL){
+    if (C_dtp[i] == NULL && !STREAM_OP(i)){
       C_dtp[i] = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
     }
   }
-  for (nv = 0; nv < MAX_OP; nv++) {
-    if (C_dtp[nv] != NULL) TOT_LOOP(k,j,i) C_dtp[nv][k][j][i] = 0.0;
+
+/* -- C_dtp is only accumulated (and read) during the 1st stage -- */
+
+  if (accum) for (nv = 0; nv < MAX_OP; nv++) {
+    if (C_dtp[nv] != NULL && !CONST_DT_OP(nv)) TOT_LOOP(k,j,i) C_dtp[nv][k][j][i] = 0.0;
   }
 
 /* --------------------------------------------------------
@@ -301,6 +467,39 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
   include[TC_OP]       = (THERMAL_CONDUCTION  == timeStepping);
   include[VISC_OP]     = (VISCOSITY           == timeStepping);
 
+/* -- Implicit and subcycled viscosity and conduction are computed
+      alone by ParabolicMGUpdate() and ParabolicSubcycle() -- */
+
+  #if PARABOLIC_MG_TC
+  include[TC_OP]   = (timeStepping == PARABOLIC_MG_STEP);
+  #endif
+  #if PARABOLIC_MG_VISC
+  include[VISC_OP] = (timeStepping == PARABOLIC_MG_STEP);
+  #endif
+  #if PARABOLIC_SUB_TC
+  include[TC_OP]   = (timeStepping == PARABOLIC_SUB_STEP);
+  #endif
+  #if PARABOLIC_SUB_VISC
+  include[VISC_OP] = (timeStepping == PARABOLIC_SUB_STEP);
+  #endif
+
+/* -- Tracer diffusion is explicit or computed alone by the
+      operator-split drivers (TracerSplitUpdate(),
+      ParabolicSubcycle()) -- */
+
+  include[TRACER_OP]   =    (TRACER_DIFFUSION == EXPLICIT
+                          && timeStepping     == (PARABOLIC_SUB_TRC ?
+                                                  PARABOLIC_SUB_STEP : EXPLICIT))
+                         || (timeStepping     == TRACER_SPLIT_STEP);
+  for (nv = TRACER_OP+1; nv < MAX_OP; nv++) include[nv] = include[TRACER_OP];
+
+/* -- Diffusion switched off at runtime -- */
+
+  if (!DiffusionConstantsGet()->on){
+    include[TC_OP] = include[VISC_OP] = 0;
+    for (nv = TRACER_OP; nv < MAX_OP; nv++) include[nv] = 0;
+  }
+
   includeDir[IDIR] = INCLUDE_IDIR;
   includeDir[JDIR] = INCLUDE_JDIR;
   includeDir[KDIR] = INCLUDE_KDIR;
@@ -321,20 +520,62 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
   }
 #endif
 
+#if TRACER_UNIFORM_GRID_ON == YES
+  {
+    static int grid_checked = 0;
+    if (!grid_checked) {
+      TracerCheckUniformGrid (grid);
+      grid_checked = 1;
+    }
+  }
+#endif
+
+#if TRACER_ACTIVE_MASK_ON == YES
+  if (include[TRACER_OP] && g_intStage == 1) TracerActiveBuild (d, grid);
+#endif
+
+/* --------------------------------------------------------
+   3a. Streaming mode: pencil operators (tracer and fused
+       ones) are swept tile by tile in all directions at
+       once, and their inverse time step is reduced in a
+       tile-sized buffer.
+   -------------------------------------------------------- */
+
+#if PARABOLIC_DT_STREAM_ON == YES
+  {
+    PTIMER_START(t0);
+    TiledPencilSweep (d, dU, domBox, aflux, dt, include, includeDir,
+                      &invDt_par, &max_invDt_cell, grid);
+    max_invDt_par = MAX(max_invDt_par, invDt_par);
+    PTIMER_STOP(PT_STREAM, t0, RBOX_ZONES(domBox));
+  }
+#endif
+
 /* --------------------------------------------------------
    4.  X1-Sweep (g_dir == IDIR)
    -------------------------------------------------------- */
 
   if (includeDir[IDIR]){
+    PTIMER_START(t_sweep);
 
     g_dir = IDIR;
 
+  /* -- Tracer diffusion (and fused operators), thread-parallel -- */
+
+    #if PARABOLIC_DT_STREAM_ON == NO
+    invDt_par     = PencilSweep (d, dU, domBox, aflux, dt,
+                                 include, C_dtp, grid);
+    max_invDt_par = MAX(max_invDt_par, invDt_par);
+    #endif
+
     KBOX_LOOP (domBox, k){ 
     JBOX_LOOP (domBox, j){ 
 
       g_j = j; g_k = k;
+      #if RESISTIVITY || (PARABOLIC_FUSED_ON == NO)
       nbeg = domBox->ibeg;
       nend = domBox->iend;
+      #endif
 
   /* -- Compute parabolic fluxes -- */
 
@@ -344,26 +585,9 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
          implemented at present. */
       #endif
 
-  /* -- Start main X1-sweep -- */
-  
-      ITOT_LOOP(i) NVAR_LOOP(nv) dU[k][j][i][nv] = 0.0;
+  /* -- Start main X1-sweep (rhs already cleared by the pencil sweep) -- */
 
   /* -- Compute total parabolic flux -- */
-     
-      static double dcoeff_trc[NTRACER];
-      int trc;
-      TRACER_RHS (d, dU, dcoeff_trc, aflux, dt, nbeg, nend, grid);
-      if (g_intStage == 1){
-        double *inv_dl = GetInverse_dl(grid);
-        for (trc = 0; trc < NTRACER; trc++){
-          IBOX_LOOP (domBox, i){  
-            double inv_dl2 = inv_dl[i]*inv_dl[i];
-            C_dtp[TRACER_OP+trc][k][j][i] += dcoeff_trc[trc]*inv_dl2;
-            invDt_par     = dcoeff_trc[trc]*inv_dl2;
-            max_invDt_par = MAX(max_invDt_par, invDt_par);
-          }
-        }  
-      }  
 
       #if RESISTIVITY
       if (include[RES_OP]){
@@ -394,9 +618,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
 
-      #if THERMAL_CONDUCTION 
+      #if THERMAL_CONDUCTION && (PARABOLIC_FUSED_ON == NO)
       if (include[TC_OP]){
+        PTIMER_START(t0);
         TC_RHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_TC, t0, nend - nbeg + 1);
         if (g_intStage == 1){
           double *inv_dl = GetInverse_dl(grid);
           IBOX_LOOP (domBox, i){  
@@ -409,9 +635,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
 
-      #if VISCOSITY
+      #if VISCOSITY && (PARABOLIC_FUSED_ON == NO)
       if (include[VISC_OP]) { 
+        PTIMER_START(t0);
         ViscousRHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_VISC, t0, nend - nbeg + 1);
         if (g_intStage == 1){
           double *inv_dl = GetInverse_dl(grid);
           IBOX_LOOP (domBox, i){  
@@ -424,6 +652,7 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif /* VISCOSITY */
     }}
+    PTIMER_STOP(PT_SWEEP+IDIR, t_sweep, RBOX_ZONES(domBox));
   } /* end if (includeDir(IDIR)) */
 
 /* --------------------------------------------------------
@@ -431,32 +660,28 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
    -------------------------------------------------------- */
 
   if (includeDir[JDIR]){
+    PTIMER_START(t_sweep);
 
     g_dir = JDIR;
 
+  /* -- Tracer diffusion (and fused operators), thread-parallel -- */
+
+    #if PARABOLIC_DT_STREAM_ON == NO
+    invDt_par     = PencilSweep (d, dU, domBox, aflux, dt,
+                                 include, C_dtp, grid);
+    max_invDt_par = MAX(max_invDt_par, invDt_par);
+    #endif
+
     KBOX_LOOP (domBox,k){
     IBOX_LOOP (domBox,i){
 
       g_i = i; g_k = k;
+      #if RESISTIVITY || (PARABOLIC_FUSED_ON == NO)
       nbeg = domBox->jbeg;
       nend = domBox->jend;
+      #endif
 
   /* -- Compute total parabolic flux -- */
-  
-      static double dcoeff_trc[NTRACER];
-      int trc;
-      TRACER_RHS (d, dU, dcoeff_trc, aflux, dt, nbeg, nend, grid);
-      if (g_intStage == 1){
-        double *inv_dl = GetInverse_dl(grid);
-        for (trc = 0; trc < NTRACER; trc++){
-          JBOX_LOOP (domBox, j){  
-            double inv_dl2 = inv_dl[j]*inv_dl[j];
-            C_dtp[TRACER_OP+trc][k][j][i] += dcoeff_trc[trc]*inv_dl2;
-            invDt_par     = dcoeff_trc[trc]*inv_dl2;
-            max_invDt_par = MAX(max_invDt_par, invDt_par);
-          }
-        }  
-      }  
       
       #if RESISTIVITY
       if (include[RES_OP]){
@@ -487,9 +712,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
   
-      #if THERMAL_CONDUCTION 
+      #if THERMAL_CONDUCTION && (PARABOLIC_FUSED_ON == NO)
       if (include[TC_OP]){
+        PTIMER_START(t0);
         TC_RHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_TC, t0, nend - nbeg + 1);
         if (g_intStage == 1){  
           double *inv_dl = GetInverse_dl(grid);
           JBOX_LOOP (domBox, j){  
@@ -502,9 +729,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
 
-      #if VISCOSITY
+      #if VISCOSITY && (PARABOLIC_FUSED_ON == NO)
       if (include[VISC_OP]) { 
+        PTIMER_START(t0);
         ViscousRHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_VISC, t0, nend - nbeg + 1);
         if (g_intStage == 1){  
           double *inv_dl = GetInverse_dl(grid);
           JBOX_LOOP (domBox, j){  
@@ -517,6 +746,7 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }  
       #endif /* VISCOSITY */
     }}
+    PTIMER_STOP(PT_SWEEP+JDIR, t_sweep, RBOX_ZONES(domBox));
   }  /* end JDIR   */
 
 /* --------------------------------------------------------
@@ -524,32 +754,28 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
    -------------------------------------------------------- */
 
   if (includeDir[KDIR]){
+    PTIMER_START(t_sweep);
 
     g_dir = KDIR;
 
+  /* -- Tracer diffusion (and fused operators), thread-parallel -- */
+
+    #if PARABOLIC_DT_STREAM_ON == NO
+    invDt_par     = PencilSweep (d, dU, domBox, aflux, dt,
+                                 include, C_dtp, grid);
+    max_invDt_par = MAX(max_invDt_par, invDt_par);
+    #endif
+
     JBOX_LOOP (domBox, j){
     IBOX_LOOP (domBox, i){
 
       g_i = i; g_j = j;
+      #if RESISTIVITY || (PARABOLIC_FUSED_ON == NO)
       nbeg = domBox->kbeg;
       nend = domBox->kend;
+      #endif
 
   /* -- Compute total parabolic flux -- */
-  
-      static double dcoeff_trc[NTRACER];
-      int trc;
-      TRACER_RHS (d, dU, dcoeff_trc, aflux, dt, nbeg, nend, grid);
-      if (g_intStage == 1){
-        double *inv_dl = GetInverse_dl(grid);
-        for (trc = 0; trc < NTRACER; trc++){
-          KBOX_LOOP (domBox, k){  
-            double inv_dl2 = inv_dl[k]*inv_dl[k];
-            C_dtp[TRACER_OP+trc][k][j][i] += dcoeff_trc[trc]*inv_dl2;
-            invDt_par     = dcoeff_trc[trc]*inv_dl2;
-            max_invDt_par = MAX(max_invDt_par, invDt_par);
-          }
-        }  
-      }
 
       #if RESISTIVITY
       if (include[RES_OP]){
@@ -579,9 +805,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
   
-      #if THERMAL_CONDUCTION 
+      #if THERMAL_CONDUCTION && (PARABOLIC_FUSED_ON == NO)
       if (include[TC_OP]){
+        PTIMER_START(t0);
         TC_RHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_TC, t0, nend - nbeg + 1);
         if (g_intStage == 1){  
           double *inv_dl = GetInverse_dl(grid);
           KBOX_LOOP (domBox, k){  
@@ -594,9 +822,11 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif
 
-      #if VISCOSITY
+      #if VISCOSITY && (PARABOLIC_FUSED_ON == NO)
       if (include[VISC_OP]) { 
+        PTIMER_START(t0);
         ViscousRHS (d, dU, dcoeff, aflux, dt, nbeg, nend, grid);
+        PTIMER_STOP(PT_VISC, t0, nend - nbeg + 1);
         if (g_intStage == 1){  
           double *inv_dl = GetInverse_dl(grid);
           KBOX_LOOP (domBox, k){  
@@ -609,6 +839,7 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
       }
       #endif /* VISCOSITY */
     }}
+    PTIMER_STOP(PT_SWEEP+KDIR, t_sweep, RBOX_ZONES(domBox));
   }  /* end KDIR */
   
 /* --------------------------------------------------------
@@ -619,22 +850,34 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
             (the same is done for hyperbolic terms).
    -------------------------------------------------------- */
 
+/* -- Constant tracer diffusivities: analytic inverse time step -- */
+
+  if (include[TRACER_OP] && accum && CONST_DT_OP(TRACER_OP)){
+    double face, cell;
+
+    TracerInvDtConst (domBox, includeDir, &face, &cell, grid);
+    max_invDt_par  = MAX(max_invDt_par, face);
+    max_invDt_cell = MAX(max_invDt_cell, cell);
+  }
+
   if (timeStepping == EXPLICIT){
     #ifdef CTU
+    PTIMER_STOP(PT_RHS, t_rhs, RBOX_ZONES(domBox));
     return max_invDt_par;
     #endif
   }
 
-  scrh = 0.0;
+  scrh = max_invDt_cell;
+  accum_trc = include[TRACER_OP] && accum && !CONST_DT_OP(TRACER_OP);
   BOX_LOOP(domBox, k,j,i){
     #if AMBIPOLAR_DIFFUSION
-    if (include[AMB_DIFF_OP]){
+    if (include[AMB_DIFF_OP] && accum){
       scrh = MAX(scrh, C_dtp[AMB_DIFF_OP][k][j][i]);
     }
     #endif
 
     #if RESISTIVITY
-    if (include[RES_OP]){
+    if (include[RES_OP] && accum){
       scrh = MAX(scrh, C_dtp[RES_OP+0][k][j][i]);
       scrh = MAX(scrh, C_dtp[RES_OP+1][k][j][i]);
       scrh = MAX(scrh, C_dtp[RES_OP+2][k][j][i]);
@@ -642,20 +885,610 @@ double ParabolicRHS (const Data *d, Data_Arr dU, RBox *domBox, double **aflux,
     #endif
 
     #if THERMAL_CONDUCTION
-    if (include[TC_OP]) scrh = MAX(scrh, C_dtp[TC_OP][k][j][i]);
+    if (include[TC_OP] && C_dtp[TC_OP] != NULL && accum){
+      scrh = MAX(scrh, C_dtp[TC_OP][k][j][i]);
+    }
     #endif
 
     #if VISCOSITY
-    if (include[VISC_OP]) scrh = MAX(scrh, C_dtp[VISC_OP][k][j][i]);
+    if (include[VISC_OP] && C_dtp[VISC_OP] != NULL && accum){
+      scrh = MAX(scrh, C_dtp[VISC_OP][k][j][i]);
+    }
     #endif
 
+    if (accum_trc){
+      for (nv = TRACER_OP; nv < TRACER_OP+NTRACER; nv++){
+        if (C_dtp[nv] != NULL) scrh = MAX(scrh, C_dtp[nv][k][j][i]);
+      }
+    }
+
     #if INTERNAL_BOUNDARY == YES
     if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) {
       NVAR_LOOP(nv) dU[k][j][i][nv] = 0.0;
     }
     #endif
   }
+  PTIMER_STOP(PT_RHS, t_rhs, RBOX_ZONES(domBox));
   return scrh;
 }
 
+#if PARABOLIC_DT_STREAM_ON == NO
+/* ********************************************************************* */
+static double PencilSweep (const Data *d, Data_Arr dU, RBox *domBox,
+                           double **aflux, double dt, int *include,
+                           double ****C_dtp, Grid *grid)
+/*!
+ * Compute the tracer diffusion right hand side on all the pencils of
+ * the current sweep direction (::g_dir).
+ * When the fused kernel is enabled (::PARABOLIC_FUSED_ON), viscosity
+ * and thermal conduction are computed here as well, in the same pass.
+ * Pencils are independent and are distributed among OpenMP threads,
+ * each thread using its own ParabolicWork scratch.
+ * During the X1-sweep, the right hand side of every pencil is also
+ * cleared here before any diffusion operator adds to it, unless the
+ * operators accumulate into the caller's dU (::rhs_accumulate).
+ *
+ * \param [in]  d        Pointer to the PLUTO data structure.
+ * \param [out] dU       Array of conservative right hand sides
+ * \param [in]  domBox   Box defining the zones to be updated
+ * \param [in]  aflux    A 2D pointer to store fluxes (needed by Chombo)
+ * \param [in]  dt       The time step
+ * \param [in]  include  Operators included during this call
+ * \param [out] C_dtp    Inverse diffusion time step of each operator,
+ *                       accumulated across directions (g_intStage == 1)
+ * \param [in]  grid     Pointer to the grid structure
+ *
+ * \return The maximum inverse diffusion time step over the pencils.
+ *********************************************************************** */
+{
+  int    dir = g_dir;
+  int    o, pb, npb, nb = PencilBatch (g_dir, include);
+  int    m, nvars, vars[NVAR];
+  int    nbeg, nend, obeg, oend, pbeg, pend;
+  double max_invDt = 0.0;
+
+/* --------------------------------------------------------
+   1. Pencils along dir are labeled by the two remaining
+      indices: (k,j) for IDIR, (k,i) for JDIR, (j,i) for KDIR
+   -------------------------------------------------------- */
+
+  if (dir == IDIR){
+    nbeg = domBox->ibeg; nend = domBox->iend;
+    obeg = domBox->kbeg; oend = domBox->kend;
+    pbeg = domBox->jbeg; pend = domBox->jend;
+  }else if (dir == JDIR){
+    nbeg = domBox->jbeg; nend = domBox->jend;
+    obeg = domBox->kbeg; oend = domBox->kend;
+    pbeg = domBox->ibeg; pend = domBox->iend;
+  }else{
+    nbeg = domBox->kbeg; nend = domBox->kend;
+    obeg = domBox->jbeg; oend = domBox->jend;
+    pbeg = domBox->ibeg; pend = domBox->iend;
+  }
+
+/* --------------------------------------------------------
+   2. Loop over pencils (or batches of nb adjacent X2
+      pencils, see PencilBatch()).
+      AMR re-fluxing (StoreAMRFlux) is not thread-safe,
+      so the loop is kept serial with Chombo.
+   -------------------------------------------------------- */
+
+  npb   = (pend - pbeg)/nb + 1;
+  nvars = RHSVars (include, vars);
+
+  #if defined(_OPENMP) && !defined(CHOMBO)
+  #pragma omp parallel for collapse(2) schedule(static) \
+                           reduction(max:max_invDt)
+  #endif
+  for (o = obeg; o <= oend; o++){
+  for (pb = 0; pb < npb; pb++){
+    int    l, p = pbeg + pb*nb, off[3] = {0, 0, 0};
+    double invDt;
+    ParabolicWork *w = GetParabolicWork (THREAD_ID);
+
+    w->dir = dir;
+    w->nb  = MIN(nb, pend - p + 1);
+    if      (dir == IDIR) {w->k = o; w->j = p; w->i = 0;}
+    else if (dir == JDIR) {w->k = o; w->i = p; w->j = 0;}
+    else                  {w->j = o; w->i = p; w->k = 0;}
+
+    if (dir == IDIR && !rhs_accumulate){
+      for (m = 0; m < nvars; m++) ITOT_LOOP(l) dU[w->k][w->j][l][vars[m]] = 0.0;
+    }
+
+    PencilRHS (d, dU, w, include, aflux, dt, nbeg, nend, grid);
+
+    if (g_intStage == 1){
+      invDt     = PencilInvDt (w, include, C_dtp, off, nbeg, nend, grid);
+      max_invDt = MAX(max_invDt, invDt);
+    }
+  }}
+
+  return max_invDt;
+}
+#endif /* PARABOLIC_DT_STREAM_ON == NO */
+
+#if PARABOLIC_DT_STREAM_ON == YES
+/* ********************************************************************* */
+static void TiledPencilSweep (const Data *d, Data_Arr dU, RBox *domBox,
+                              double **aflux, double dt, int *include,
+                              int *includeDir, double *max_face,
+                              double *max_cell, Grid *grid)
+/*!
+ * Streaming version of PencilSweep() covering all directions.
+ * The domain is split into tiles of PARABOLIC_TILE zones in the
+ * X2 (and X3) direction, spanning the whole X1 range.
+ * For each tile, X1 pencils are computed first (clearing the rhs,
+ * unless ::rhs_accumulate is set), followed by the X2 and X3 pencil
+ * segments crossing the tile.
+ * During the 1st stage the inverse time step of every operator is
+ * summed across directions in the thread-private tile buffer
+ * w->C_tile and reduced to its maximum before moving to the next
+ * tile, so that no full-grid storage is needed.
+ *
+ * \param [in]  d           Pointer to the PLUTO data structure.
+ * \param [out] dU          Array of conservative right hand sides
+ * \param [in]  domBox      Box defining the zones to be updated
+ * \param [in]  aflux       A 2D pointer to store fluxes (unused)
+ * \param [in]  dt          The time step
+ * \param [in]  include     Operators included during this call
+ * \param [in]  includeDir  Directions included during this call
+ * \param [out] max_face    Maximum inverse time step at interfaces
+ * \param [out] max_cell    Maximum over zones of the inverse time step
+ *                          summed across directions
+ * \param [in]  grid        Pointer to the grid structure
+ *********************************************************************** */
+{
+  int    jt, kt, ntj, ntk;
+  int    nb = PencilBatch (JDIR, include);
+  int    accum = (g_intStage == 1), skip[MAX_OP];
+  int    nvars, vars[NVAR];
+  double mface = 0.0, mcell = 0.0;
+
+  for (jt = 0; jt < MAX_OP; jt++) skip[jt] = CONST_DT_OP(jt);
+  nvars = RHSVars (include, vars);
+
+  ntj = (domBox->jend - domBox->jbeg)/PARABOLIC_TILE + 1;
+  ntk = (domBox->kend - domBox->kbeg)/PARABOLIC_TILE + 1;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) schedule(static) \
+                           reduction(max:mface,mcell)
+  #endif
+  for (kt = 0; kt < ntk; kt++){
+  for (jt = 0; jt < ntj; jt++){
+    int    i, j, k, l, m, op, off[3];
+    int    j0, j1, k0, k1;
+    int    ibeg = domBox->ibeg, iend = domBox->iend;
+    double invDt, ****C;
+    ParabolicWork *w = GetParabolicWork (THREAD_ID);
+
+    j0 = domBox->jbeg + jt*PARABOLIC_TILE;
+    k0 = domBox->kbeg + kt*PARABOLIC_TILE;
+    j1 = MIN(j0 + PARABOLIC_TILE - 1, domBox->jend);
+    k1 = MIN(k0 + PARABOLIC_TILE - 1, domBox->kend);
+
+    C = w->C_tile;
+    off[IDIR] = 0; off[JDIR] = j0; off[KDIR] = k0;
+    if (accum) for (op = 0; op < MAX_OP; op++){
+      if (C[op] == NULL || skip[op]) continue;
+      for (k = k0; k <= k1; k++) for (j = j0; j <= j1; j++){
+        ITOT_LOOP(i) C[op][k-k0][j-j0][i] = 0.0;
+      }
+    }
+
+  /* -- X1 pencils -- */
+
+    if (includeDir[IDIR]) for (k = k0; k <= k1; k++) for (j = j0; j <= j1; j++){
+      w->dir = IDIR; w->i = 0; w->j = j; w->k = k; w->nb = 1;
+      if (!rhs_accumulate) for (m = 0; m < nvars; m++) ITOT_LOOP(l) dU[k][j][l][vars[m]] = 0.0;
+      PencilRHS (d, dU, w, include, aflux, dt, ibeg, iend, grid);
+      if (accum) {
+        invDt = PencilInvDt (w, include, C, off, ibeg, iend, grid);
+        mface = MAX(mface, invDt);
+      }
+    }
+
+  /* -- X2 pencil segments crossing the tile -- */
+
+    if (includeDir[JDIR]) for (k = k0; k <= k1; k++) for (i = ibeg; i <= iend; i += nb){
+      w->dir = JDIR; w->i = i; w->j = 0; w->k = k; w->nb = MIN(nb, iend - i + 1);
+      PencilRHS (d, dU, w, include, aflux, dt, j0, j1, grid);
+      if (accum) {
+        invDt = PencilInvDt (w, include, C, off, j0, j1, grid);
+        mface = MAX(mface, invDt);
+      }
+    }
+
+  /* -- X3 pencil segments crossing the tile -- */
+
+    if (includeDir[KDIR]) for (j = j0; j <= j1; j++) for (i = ibeg; i <= iend; i++){
+      w->dir = KDIR; w->i = i; w->j = j; w->k = 0; w->nb = 1;
+      PencilRHS (d, dU, w, include, aflux, dt, k0, k1, grid);
+      if (accum) {
+        invDt = PencilInvDt (w, include, C, off, k0, k1, grid);
+        mface = MAX(mface, invDt);
+      }
+    }
+
+  /* -- Reduce the tile buffer -- */
+
+    if (accum) for (op = 0; op < MAX_OP; op++){
+      if (C[op] == NULL || !include[op] || skip[op]) continue;
+      for (k = k0; k <= k1; k++) for (j = j0; j <= j1; j++){
+        for (i = ibeg; i <= iend; i++) mcell = MAX(mcell, C[op][k-k0][j-j0][i]);
+      }
+    }
+  }}
+
+  *max_face = mface;
+  *max_cell = mcell;
+}
+#endif /* PARABOLIC_DT_STREAM_ON == YES */
+
+/* ********************************************************************* */
+static void PencilRHS (const Data *d, Data_Arr dU, ParabolicWork *w,
+                       int *include, double **aflux, double dt,
+                       int beg, int end, Grid *grid)
+/*!
+ * Add the right hand side of the pencil operators (tracer diffusion
+ * and, with the fused kernel, thermal conduction and viscosity) in
+ * zones beg..end of the pencil (or pencil segment) described by w.
+ *********************************************************************** */
+{
+  #if TRACER_JBATCH > 1
+  if (w->nb > 1){   /* Batch of X2 pencils, tracer only (PencilBatch()) */
+    #if TRACER_ACTIVE_MASK_ON == YES
+    int l, lend;
+    for (l = beg; l <= end; l = lend + 1){
+      if (TracerActiveRun (w, l, end, &lend)) {
+        PTIMER_START(t0);
+        TRACER_RHS_Batch (d, dU, w, dt, l, lend, grid);
+        PTIMER_STOP(PT_TRACER, t0, (long)w->nb*(lend - l + 1));
+      }
+    }
+    #else
+    PTIMER_START(t0);
+    TRACER_RHS_Batch (d, dU, w, dt, beg, end, grid);
+    PTIMER_STOP(PT_TRACER, t0, (long)w->nb*(end - beg + 1));
+    #endif
+    return;
+  }
+  #endif
+
+  #if TRACER_ACTIVE_MASK_ON == YES
+  int l, lend, act;
+
+  if (include[TRACER_OP]){
+    for (l = beg; l <= end; l = lend + 1){
+      act = TracerActiveRun (w, l, end, &lend);
+      #if PARABOLIC_FUSED_ON == YES
+      if (act || include[TC_OP] || include[VISC_OP]){
+        PTIMER_START(t0);
+        ParabolicFusedRHS (d, dU, w, act, include[TC_OP],
+                           include[VISC_OP], dt, l, lend, grid);
+        PTIMER_STOP(PT_FUSED, t0, lend - l + 1);
+      }
+      #else
+      if (act) {
+        PTIMER_START(t0);
+        TRACER_RHS (d, dU, w, aflux, dt, l, lend, grid);
+        PTIMER_STOP(PT_TRACER, t0, lend - l + 1);
+      }
+      #endif
+    }
+    return;
+  }
+  #endif
+
+  #if PARABOLIC_FUSED_ON == YES
+  if (include[TRACER_OP] || include[TC_OP] || include[VISC_OP]){
+    PTIMER_START(t0);
+    ParabolicFusedRHS (d, dU, w, include[TRACER_OP], include[TC_OP],
+                       include[VISC_OP], dt, beg, end, grid);
+    PTIMER_STOP(PT_FUSED, t0, end - beg + 1);
+  }
+  #else
+  if (include[TRACER_OP]) {
+    PTIMER_START(t0);
+    TRACER_RHS (d, dU, w, aflux, dt, beg, end, grid);
+    PTIMER_STOP(PT_TRACER, t0, end - beg + 1);
+  }
+  #endif
+}
+
+/* ********************************************************************* */
+static double PencilInvDt (ParabolicWork *w, int *include, double ****C,
+                           int *off, int beg, int end, Grid *grid)
+/*!
+ * Add the contribution of the pencil operators in zones beg..end to
+ * their inverse diffusion time steps C[op][k][j][i].
+ * The origin of C is shifted by off[] (zero for full-grid arrays,
+ * the tile corner for tile buffers).
+ *
+ * \return The maximum inverse time step at the pencil interfaces.
+ *********************************************************************** */
+{
+  int    l, c, trc, dir = w->dir, ind[3];
+  double *inv_dl = GetPencilInverse_dl (w, grid);
+  double inv_dl2, invDt, max_invDt = 0.0;
+
+  ind[IDIR] = w->i - off[IDIR];
+  ind[JDIR] = w->j - off[JDIR];
+  ind[KDIR] = w->k - off[KDIR];
+
+  if (include[TRACER_OP] && !CONST_DT_OP(TRACER_OP))
+                         for (c = 0; c < w->nb; c++)
+                         for (trc = 0; trc < NTRACER; trc++){
+    #if TRACER_ACTIVE_MASK_ON == YES
+    int lrun = beg - 1, act = 1;
+    #endif
+    ind[IDIR] = w->i + c - off[IDIR];   /* Batches are along IDIR */
+    for (l = beg; l <= end; l++){
+      #if TRACER_ACTIVE_MASK_ON == YES
+      if (l > lrun) act = TracerActiveRun (w, l, end, &lrun);
+      if (!act) {l = lrun; continue;}   /* Skip inactive tiles */
+      #endif
+      ind[dir]  = l - off[dir];
+      inv_dl2   = inv_dl[l]*inv_dl[l];
+      invDt     = w->dcoeff_trc[trc]*inv_dl2;
+      C[TRACER_OP+trc][ind[KDIR]][ind[JDIR]][ind[IDIR]] += invDt;
+      max_invDt = MAX(max_invDt, invDt);
+    }
+  }
+
+  #if PARABOLIC_FUSED_ON == YES
+  if (include[TC_OP]){
+    invDt     = FaceInvDt (C[TC_OP], w->dcoeff_tc, inv_dl, ind, off[dir],
+                           dir, beg, end);
+    max_invDt = MAX(max_invDt, invDt);
+  }
+  if (include[VISC_OP]){
+    invDt     = FaceInvDt (C[VISC_OP], w->dcoeff_visc, inv_dl, ind, off[dir],
+                           dir, beg, end);
+    max_invDt = MAX(max_invDt, invDt);
+  }
+  #endif
+
+  return max_invDt;
+}
+
+#if PARABOLIC_FUSED_ON == YES
+/* ********************************************************************* */
+static double FaceInvDt (double ***C, double *dcoeff, double *inv_dl,
+                         int *ind, int off, int dir, int beg, int end)
+/*!
+ * Same as PencilInvDt() for an operator whose coefficients dcoeff are
+ * defined at cell interfaces (as in the serial sweeps of
+ * ParabolicRHS()).
+ *********************************************************************** */
+{
+  int    l;
+  double inv_dl2, invDt, max_invDt = 0.0;
+
+  for (l = beg; l <= end; l++){
+    ind[dir] = l - off;
+    inv_dl2  = inv_dl[l]*inv_dl[l];
+    C[ind[KDIR]][ind[JDIR]][ind[IDIR]] += 0.5*(dcoeff[l-1] + dcoeff[l])*inv_dl2;
+    invDt     = dcoeff[l]*inv_dl2;
+    max_invDt = MAX(max_invDt, invDt);
+  }
+  return max_invDt;
+}
+#endif
+
+/* ********************************************************************* */
+static void TracerInvDtConst (RBox *box, int *includeDir, double *max_face,
+                              double *max_cell, Grid *grid)
+/*!
+ * Inverse diffusion time step of tracers with spatially constant
+ * diffusivity on a Cartesian grid.
+ * The zone value nu*sum_d(1/dx_d^2) is separable, so its maximum over
+ * the box is the sum of the per-direction maxima; results coincide
+ * with those accumulated by PencilInvDt() over all the zones, so it is
+ * not used with the activity mask (see CONST_DT_OP()).
+ *
+ * \param [in]  box         Box defining the zones to be updated
+ * \param [in]  includeDir  Directions included during this call
+ * \param [out] max_face    Maximum inverse time step at interfaces
+ * \param [out] max_cell    Maximum over zones of the inverse time step
+ *                          summed across directions
+ * \param [in]  grid        Pointer to the grid structure
+ *********************************************************************** */
+{
+  int    n, dir, l, beg[3], end[3];
+  double nu, invDt, mdir, cell, face = 0.0, mcell = 0.0;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
+
+  beg[IDIR] = box->ibeg; end[IDIR] = box->iend;
+  beg[JDIR] = box->jbeg; end[JDIR] = box->jend;
+  beg[KDIR] = box->kbeg; end[KDIR] = box->kend;
+
+  for (n = 0; n < NTRACER; n++){
+    nu   = fabs(dc->nu_trc[n]);
+    cell = 0.0;
+    for (dir = 0; dir < 3; dir++){
+      if (!includeDir[dir]) continue;
+      mdir = 0.0;
+      for (l = beg[dir]; l <= end[dir]; l++){
+        invDt = nu*(grid->inv_dx[dir][l]*grid->inv_dx[dir][l]);
+        mdir  = MAX(mdir, invDt);
+      }
+      cell += mdir;
+      face  = MAX(face, mdir);
+    }
+    mcell = MAX(mcell, cell);
+  }
+  *max_face = face;
+  *max_cell = mcell;
+}
+
+/* ********************************************************************* */
+static int PencilBatch (int dir, int *include)
+/*!
+ * Return the number of adjacent pencils processed together by the
+ * pencil sweeps in the direction dir.
+ * Only X2 pencils carrying tracer diffusion are batched
+ * (TRACER_RHS_Batch()).
+ * The fused kernel works one pencil at a time, so batching is off when
+ * it also carries thermal conduction or viscosity; without the fused
+ * kernel these are done by the serial sweeps and do not matter here.
+ *********************************************************************** */
+{
+  #if (TRACER_JBATCH > 1) && !defined(CHOMBO)
+  if (dir == JDIR && include[TRACER_OP]) {
+    #if PARABOLIC_FUSED_ON == YES
+    if (include[TC_OP] || include[VISC_OP]) return 1;
+    #endif
+    return TRACER_JBATCH;
+  }
+  #endif
+  return 1;
+}
+
+/* ********************************************************************* */
+static int RHSVars (int *include, int *vars)
+/*!
+ * List in vars[] the conservative components written by the included
+ * operators, which are the only ones cleared by the X1 sweep.
+ * Operators with an energy flux list all momentum (and magnetic
+ * field) components, which are also read by the entropy switch.
+ *
+ * \return The number of components.
+ *********************************************************************** */
+{
+  int n = 0, m, op;
+  int eng = include[TC_OP] || include[VISC_OP] || include[RES_OP] ||
+            include[AMB_DIFF_OP];
+
+  if (eng){
+    for (m = 0; m < COMPONENTS; m++) vars[n++] = MX1 + m;
+    #if PHYSICS == MHD
+    for (m = 0; m < COMPONENTS; m++) vars[n++] = BX1 + m;
+    #endif
+    #if HAVE_ENERGY
+    vars[n++] = ENG;
+    #endif
+  }
+  for (op = TRACER_OP; op < TRACER_OP + NTRACER; op++){
+    if (include[op]) vars[n++] = TRC + op - TRACER_OP;
+  }
+  return n;
+}
+
+#if PARABOLIC_SPLIT == YES
+/* ********************************************************************* */
+static int SplitVars (int *vars)
+/*!
+ * List in vars[] the conservative components written by the
+ * operator-split drivers, the only ones stored in split_rhs.
+ *
+ * \return The number of components.
+ *********************************************************************** */
+{
+  int n = 0, m;
+
+  #if (SPECTRAL_VISCOSITY == YES) || (PARABOLIC_MG_ON == YES) || PARABOLIC_SUB_VISC
+  for (m = 0; m < COMPONENTS; m++) vars[n++] = MX1 + m;
+  #endif
+  #if (PARABOLIC_MG_ON == YES) || PARABOLIC_SUB_VISC || PARABOLIC_SUB_TC
+  vars[n++] = ENG;
+  #endif
+  #if (TRACER_DIFFUSION != EXPLICIT) || PARABOLIC_SUB_TRC
+  for (m = 0; m < NTRACER; m++) vars[n++] = TRC + m;
+  #endif
+  return n;
+}
+#endif
+
+/* ********************************************************************* */
+ParabolicWork *GetParabolicWork (int tid)
+/*!
+ * Return the scratch workspace of thread \c tid.
+ * Workspaces for all threads are allocated during the first call,
+ * which must therefore be made outside of any parallel region.
+ *
+ * \param [in] tid   the thread number (0 for serial runs)
+ *
+ * \return A pointer to the ParabolicWork structure of the thread.
+ *********************************************************************** */
+{
+  int n, nthreads = 1;
+  #if PARABOLIC_DT_STREAM_ON == YES
+  int op;
+  #endif
+  static ParabolicWork *work;
+
+  if (work == NULL){
+    #ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+    #endif
+    work = ARRAY_1D(nthreads, ParabolicWork);
+    for (n = 0; n < nthreads; n++){
+      work[n].vn          = ARRAY_2D(NMAX_POINT, NVAR, double);
+      work[n].vi          = ARRAY_2D(NVAR, NMAX_POINT, double);
+      work[n].nu1         = ARRAY_1D(NMAX_POINT, double);
+      work[n].nu2         = ARRAY_1D(NMAX_POINT, double);
+      work[n].kpar        = ARRAY_1D(NMAX_POINT, double);
+      work[n].knor        = ARRAY_1D(NMAX_POINT, double);
+      work[n].phi         = ARRAY_1D(NMAX_POINT, double);
+      work[n].fA          = ARRAY_1D(NMAX_POINT, double);
+      work[n].inv_dl      = ARRAY_1D(NMAX_POINT, double);
+      work[n].tracer_flux = ARRAY_2D(NMAX_POINT, NTRACER, double);
+      work[n].gradTRC     = ARRAY_3D(NTRACER, NMAX_POINT, 3, double);
+      work[n].par_flux    = ARRAY_2D(NMAX_POINT, NVAR, double);
+      work[n].dcoeff_tc   = ARRAY_1D(NMAX_POINT, double);
+      work[n].dcoeff_visc = ARRAY_1D(NMAX_POINT, double);
+      work[n].C_tile      = ARRAY_1D(MAX_OP, double ***);
+      work[n].nb          = 1;
+      #if TRACER_JBATCH > 1
+      work[n].batch_rho   = ARRAY_2D(NMAX_POINT, TRACER_JBATCH, double);
+      work[n].batch_C     = ARRAY_2D(NMAX_POINT, TRACER_JBATCH, double);
+      work[n].batch_flux  = ARRAY_2D(NMAX_POINT, TRACER_JBATCH, double);
+      #endif
+      #if PARABOLIC_DT_STREAM_ON == YES
+      for (op = 0; op < MAX_OP; op++){
+        if (!STREAM_OP(op)) continue;
+        if (op == TC_OP   && !THERMAL_CONDUCTION) continue;
+        if (op == VISC_OP && !VISCOSITY)          continue;
+        work[n].C_tile[op] = ARRAY_3D(DIMENSIONS == 3 ? PARABOLIC_TILE : 1,
+                                      PARABOLIC_TILE, NX1_MAX, double);
+      }
+      #endif
+    }
+  }
+  return work + tid;
+}
+
+/* ********************************************************************* */
+double *GetPencilInverse_dl (ParabolicWork *w, Grid *grid)
+/*!
+ * Thread-safe version of GetInverse_dl(): return the inverse of the
+ * line element along the pencil described by \c w.
+ * In curvilinear coordinates the result is stored in w->inv_dl.
+ *********************************************************************** */
+{
+  if (w->dir == IDIR){
+    return grid->inv_dx[IDIR];
+  }else if (w->dir == JDIR){
+    #if GEOMETRY == POLAR || GEOMETRY == SPHERICAL
+    int    l;
+    double r_1 = 1.0/grid->x[IDIR][w->i];
+    JTOT_LOOP(l) w->inv_dl[l] = grid->inv_dx[JDIR][l]*r_1;
+    return w->inv_dl;
+    #else
+    return grid->inv_dx[JDIR];
+    #endif
+  }else{
+    #if GEOMETRY == SPHERICAL
+    int    l;
+    double rs_1 = 1.0/(grid->x[IDIR][w->i]*sin(grid->x[JDIR][w->j]));
+    KTOT_LOOP(l) w->inv_dl[l] = grid->inv_dx[KDIR][l]*rs_1;
+    return w->inv_dl;
+    #else
+    return grid->inv_dx[KDIR];
+    #endif
+  }
+}
+
 #endif /* PARABOLIC_FLUX != NO */
@@ -0,0 +1,334 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Exact spectral integration of constant-coefficient diffusion.
+
+  On a fully periodic box with uniform spacing, tracer diffusion with
+  constant diffusivity \f$\nu_C\f$ is integrated exactly over a time
+  step by damping every Fourier mode:
+  \f[
+     \hat{C}(\vec{k}, t + \Delta t) = e^{-\nu_C k^2\Delta t}\hat{C}(\vec{k}, t)
+  \f]
+  When ::SPECTRAL_VISCOSITY is enabled, the same is done for the
+  velocity, splitting each mode into its solenoidal and compressive parts
+  which, for a constant kinematic viscosity \f$\nu\f$ (\f$\nu_2 = 0\f$),
+  decay as \f$e^{-\nu k^2\Delta t}\f$ and
+  \f$e^{-\frac{4}{3}\nu k^2\Delta t}\f$, respectively.
+  The total energy is left unchanged, so that the kinetic energy removed
+  is turned into heat.
+  Both are exact when the density is uniform; otherwise they neglect the
+  density gradient terms of the diffusive fluxes.
+
+  The stage is operator-split: it is called at the beginning of the step
+  by ParabolicUpdate() and returns \f$\Delta U/\Delta t\f$, which is added
+  to every Runge-Kutta stage.
+  It adds no constraint to the parabolic time step.
+
+  Transforms are done with the built-in radix-2 FFT (fft.c) over the
+  local domain, which therefore must be the whole (periodic) domain:
+  one process per periodic direction and power-of-two resolution.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if (PARABOLIC_FLUX != NO) && \
+    ((TRACER_DIFFUSION == SPECTRAL) || (SPECTRAL_VISCOSITY == YES))
+
+static FFTPlan *plan[3];
+static int     nx[3], nh;
+
+static void SpectralCheckGrid (Grid *);
+static void SpectralForward (double ***, double ****);
+static void SpectralInverse (double ****, double ***);
+
+/* ********************************************************************* */
+void SpectralDiffusion (const Data *d, double ****dU, RBox *box,
+                        double dt, Grid *grid)
+/*!
+ * Compute the conservative increment rate of the spectrally integrated
+ * operators.
+ *
+ * \param [in]  d      pointer to PLUTO Data structure (state at t^n)
+ * \param [out] dU     the rate dU[nv][k][j][i] = Delta(U_nv)/dt for
+ *                     tracers (and momenta); other components are
+ *                     left untouched.
+ * \param [in]  box    box defining the zones to be updated
+ * \param [in]  dt     the time step
+ * \param [in]  grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, m, mi, mj, mk, dir;
+  static double ***q, ****S[COMPONENTS];
+  static double *kv[3];
+  const DiffusionConstants *dconst = DiffusionConstantsGet();
+  double nu    = dconst->nu_visc;
+
+/* --------------------------------------------------------
+   0. Check grid and create plans, spectral buffers and
+      wavenumber tables on first call
+   -------------------------------------------------------- */
+
+  if (q == NULL){
+    SpectralCheckGrid (grid);
+
+    for (dir = 0; dir < 3; dir++){
+      double L = grid->xend_glob[dir] - grid->xbeg_glob[dir];
+
+      nx[dir] = grid->np_int_glob[dir];
+      plan[dir] = FFT_CreatePlan (nx[dir], dir == IDIR);
+      kv[dir]   = ARRAY_1D(nx[dir], double);
+      for (m = 0; m < nx[dir]; m++){
+        kv[dir][m] = 2.0*CONST_PI*(m <= nx[dir]/2 ? m : m - nx[dir])/L;
+      }
+    }
+    nh = nx[IDIR]/2 + 1;
+    q  = ARRAY_3D(nx[KDIR], nx[JDIR], nx[IDIR], double);
+    #if SPECTRAL_VISCOSITY == YES
+    for (n = 0; n < COMPONENTS; n++){
+      S[n] = ARRAY_4D(nx[KDIR], nx[JDIR], nh, 2, double);
+    }
+    #else
+    S[0] = ARRAY_4D(nx[KDIR], nx[JDIR], nh, 2, double);
+    #endif
+  }
+
+/* --------------------------------------------------------
+   1. Tracers: multiply by exp(-nu k^2 dt)
+   -------------------------------------------------------- */
+
+#if TRACER_DIFFUSION == SPECTRAL
+  for (n = 0; n < NTRACER; n++){
+    double nu_trc = fabs(dconst->nu_trc[n]);
+
+    DOM_LOOP(k,j,i) q[k-KBEG][j-JBEG][i-IBEG] = d->Vc[TRC+n][k][j][i];
+    SpectralForward (q, S[0]);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for collapse(2) private(mi)
+    #endif
+    for (mk = 0; mk < nx[KDIR]; mk++){
+    for (mj = 0; mj < nx[JDIR]; mj++){
+      for (mi = 0; mi < nh; mi++){
+        double k2 =   kv[IDIR][mi]*kv[IDIR][mi] + kv[JDIR][mj]*kv[JDIR][mj]
+                    + kv[KDIR][mk]*kv[KDIR][mk];
+        double damp = exp(-nu_trc*k2*dt);
+        S[0][mk][mj][mi][0] *= damp;
+        S[0][mk][mj][mi][1] *= damp;
+      }
+    }}
+
+    SpectralInverse (S[0], q);
+    DOM_LOOP(k,j,i){
+      dU[TRC+n][k][j][i] =   d->Vc[RHO][k][j][i]
+                           *(q[k-KBEG][j-JBEG][i-IBEG] - d->Vc[TRC+n][k][j][i])/dt;
+    }
+  }
+#endif
+
+/* --------------------------------------------------------
+   2. Velocity: damp solenoidal and compressive parts of
+      each mode separately
+   -------------------------------------------------------- */
+
+#if SPECTRAL_VISCOSITY == YES
+  for (n = 0; n < COMPONENTS; n++){
+    DOM_LOOP(k,j,i) q[k-KBEG][j-JBEG][i-IBEG] = d->Vc[VX1+n][k][j][i];
+    SpectralForward (q, S[n]);
+  }
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) private(mi,n)
+  #endif
+  for (mk = 0; mk < nx[KDIR]; mk++){
+  for (mj = 0; mj < nx[JDIR]; mj++){
+    for (mi = 0; mi < nh; mi++){
+      double kk[3], k2, ds, dc, kvr, kvi;
+
+      kk[0] = kv[IDIR][mi]; kk[1] = kv[JDIR][mj]; kk[2] = kv[KDIR][mk];
+      k2    = kk[0]*kk[0] + kk[1]*kk[1] + kk[2]*kk[2];
+      if (k2 == 0.0) continue;
+      ds = exp(-nu*k2*dt);
+      dc = exp(-4.0/3.0*nu*k2*dt);
+
+    /* -- (k.v)/k^2 gives the compressive part k(k.v)/k^2 -- */
+
+      kvr = kvi = 0.0;
+      for (n = 0; n < COMPONENTS; n++){
+        kvr += kk[n]*S[n][mk][mj][mi][0];
+        kvi += kk[n]*S[n][mk][mj][mi][1];
+      }
+      kvr /= k2; kvi /= k2;
+      for (n = 0; n < COMPONENTS; n++){
+        S[n][mk][mj][mi][0] = ds*S[n][mk][mj][mi][0] + (dc - ds)*kk[n]*kvr;
+        S[n][mk][mj][mi][1] = ds*S[n][mk][mj][mi][1] + (dc - ds)*kk[n]*kvi;
+      }
+    }
+  }}
+
+  for (n = 0; n < COMPONENTS; n++){
+    SpectralInverse (S[n], q);
+    DOM_LOOP(k,j,i){
+      dU[MX1+n][k][j][i] =   d->Vc[RHO][k][j][i]
+                           *(q[k-KBEG][j-JBEG][i-IBEG] - d->Vc[VX1+n][k][j][i])/dt;
+    }
+  }
+#endif
+}
+
+/* ********************************************************************* */
+void SpectralCheckGrid (Grid *grid)
+/*!
+ * Make sure the local domain is the whole periodic box with uniform
+ * spacing, as required by the spectral stage.
+ *********************************************************************** */
+{
+  int dir, i;
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    double dx0 = grid->dx[dir][grid->beg[dir]];
+
+    if (grid->nproc[dir] != 1 || grid->lbound[dir] != PERIODIC
+                              || grid->rbound[dir] != PERIODIC){
+      printLog ("! SpectralDiffusion(): direction %d must be periodic and not"
+                " decomposed among processes\n", dir);
+      QUIT_PLUTO(1);
+    }
+    for (i = grid->beg[dir]; i <= grid->end[dir]; i++){
+      if (fabs(grid->dx[dir][i] - dx0) > 1.e-9*dx0){
+        printLog ("! SpectralDiffusion(): non-uniform grid in direction %d\n",
+                  dir);
+        QUIT_PLUTO(1);
+      }
+    }
+  }
+}
+
+/* ********************************************************************* */
+void SpectralForward (double ***q, double ****S)
+/*!
+ * Forward transform of the real field q[k][j][i] into the half spectrum
+ * S[k][j][m][re/im], m = 0..nx/2.
+ * q is overwritten.
+ *********************************************************************** */
+{
+  int j, k, m;
+
+/* -- X1: real-to-complex transform of each row -- */
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2)
+  #endif
+  for (k = 0; k < nx[KDIR]; k++){
+  for (j = 0; j < nx[JDIR]; j++){
+    FFT_RealForward (plan[IDIR], q[k][j], S[k][j][0]);
+  }}
+
+/* -- X2 and X3: complex transforms of each column -- */
+
+  #ifdef _OPENMP
+  #pragma omp parallel private(j,m)
+  #endif
+  {
+    double *z = (double *) malloc(2*MAX(nx[JDIR], nx[KDIR])*sizeof(double));
+    int    l;
+
+    if (nx[JDIR] > 1){
+      #ifdef _OPENMP
+      #pragma omp for collapse(2)
+      #endif
+      for (k = 0; k < nx[KDIR]; k++){
+      for (m = 0; m < nh; m++){
+        for (l = 0; l < nx[JDIR]; l++){
+          z[2*l] = S[k][l][m][0]; z[2*l+1] = S[k][l][m][1];
+        }
+        FFT_Complex (plan[JDIR], z, -1);
+        for (l = 0; l < nx[JDIR]; l++){
+          S[k][l][m][0] = z[2*l]; S[k][l][m][1] = z[2*l+1];
+        }
+      }}
+    }
+
+    if (nx[KDIR] > 1){
+      #ifdef _OPENMP
+      #pragma omp for collapse(2)
+      #endif
+      for (j = 0; j < nx[JDIR]; j++){
+      for (m = 0; m < nh; m++){
+        for (l = 0; l < nx[KDIR]; l++){
+          z[2*l] = S[l][j][m][0]; z[2*l+1] = S[l][j][m][1];
+        }
+        FFT_Complex (plan[KDIR], z, -1);
+        for (l = 0; l < nx[KDIR]; l++){
+          S[l][j][m][0] = z[2*l]; S[l][j][m][1] = z[2*l+1];
+        }
+      }}
+    }
+    free(z);
+  }
+}
+
+/* ********************************************************************* */
+void SpectralInverse (double ****S, double ***q)
+/*!
+ * Inverse of SpectralForward(), including normalization.
+ * S is overwritten.
+ *********************************************************************** */
+{
+  int    i, j, k, m;
+  double norm = 1.0/((double)nx[IDIR]*nx[JDIR]*nx[KDIR]);
+
+  #ifdef _OPENMP
+  #pragma omp parallel private(j,k,m)
+  #endif
+  {
+    double *z = (double *) malloc(2*MAX(nx[JDIR], nx[KDIR])*sizeof(double));
+    int    l;
+
+    if (nx[KDIR] > 1){
+      #ifdef _OPENMP
+      #pragma omp for collapse(2)
+      #endif
+      for (j = 0; j < nx[JDIR]; j++){
+      for (m = 0; m < nh; m++){
+        for (l = 0; l < nx[KDIR]; l++){
+          z[2*l] = S[l][j][m][0]; z[2*l+1] = S[l][j][m][1];
+        }
+        FFT_Complex (plan[KDIR], z, +1);
+        for (l = 0; l < nx[KDIR]; l++){
+          S[l][j][m][0] = z[2*l]; S[l][j][m][1] = z[2*l+1];
+        }
+      }}
+    }
+
+    if (nx[JDIR] > 1){
+      #ifdef _OPENMP
+      #pragma omp for collapse(2)
+      #endif
+      for (k = 0; k < nx[KDIR]; k++){
+      for (m = 0; m < nh; m++){
+        for (l = 0; l < nx[JDIR]; l++){
+          z[2*l] = S[k][l][m][0]; z[2*l+1] = S[k][l][m][1];
+        }
+        FFT_Complex (plan[JDIR], z, +1);
+        for (l = 0; l < nx[JDIR]; l++){
+          S[k][l][m][0] = z[2*l]; S[k][l][m][1] = z[2*l+1];
+        }
+      }}
+    }
+    free(z);
+  }
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) private(i)
+  #endif
+  for (k = 0; k < nx[KDIR]; k++){
+  for (j = 0; j < nx[JDIR]; j++){
+    FFT_RealInverse (plan[IDIR], S[k][j][0], q[k][j]);
+    for (i = 0; i < nx[IDIR]; i++) q[k][j][i] *= norm;
+  }}
+}
+
+#endif /* SPECTRAL */
@@ -15,6 +15,7 @@
 */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
+#include "local_pluto.h"
 
 /* ********************************************************************* */
 void TC_kappa(double *v, double x1, double x2, double x3,
@@ -36,20 +37,48 @@ void TC_kappa(double *v, double x1, double x2, double x3,
  *    
  *********************************************************************** */
 {
-  double mu = 0.5;
-  double del_u = 2*g_inputParam[U_FLOW]; // CGS
-  double chi   = g_inputParam[LENGTH]*del_u/g_inputParam[REYNOLDS]; 
+  const DiffusionConstants *dc = DiffusionConstantsGet();
 
-  *kpar = (v[RHO]*UNIT_DENSITY/(CONST_mp*mu))*CONST_kB*chi;
+/* -- kpar = n kB chi, already normalized to code units -- */
+
+  *kpar = v[RHO]*dc->kappa_tc;
   
 #if PHYSICS == MHD
   *knor = 0.0;
 #endif
-  
-/* Normalize to code units */
 
-  (*kpar) *= CONST_mp*mu/(UNIT_DENSITY*UNIT_VELOCITY*UNIT_LENGTH*CONST_kB);
-  (*knor) *= CONST_mp*mu/(UNIT_DENSITY*UNIT_VELOCITY*UNIT_LENGTH*CONST_kB);
+  *phi = dc->phi_tc;
+}
+
+/* ********************************************************************* */
+void TC_kappaPencil(double **v, int beg, int end, const ParabolicWork *w,
+                    Grid *grid, double *kpar, double *knor, double *phi)
+/*!
+ * Pencil version of TC_kappa(): fill the thermal conduction
+ * coefficients at the interfaces beg..end of the pencil described by
+ * w (see Visc_nuPencil() for the interface coordinates).
+ *
+ * \param [in] v     interface states, v[nv][l]
+ * \param [in] beg   first interface
+ * \param [in] end   last interface
+ * \param [in] w     pointer to the pencil workspace
+ * \param [in] grid  pointer to Grid structure
+ * \param [out] kpar  \f$ \kappa_\parallel \f$, kpar[l]
+ * \param [out] knor  \f$ \kappa_\perp \f$, knor[l] (MHD only)
+ * \param [out] phi   saturation parameter, phi[l]
+ *    
+ *********************************************************************** */
+{
+  int    l;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
+  double kappa = dc->kappa_tc, phi0 = dc->phi_tc;
+  double *rho  = v[RHO];
 
-  *phi = 0.3;
+  for (l = beg; l <= end; l++){
+    kpar[l] = rho[l]*kappa;
+    phi[l]  = phi0;
+  }
+#if PHYSICS == MHD
+  for (l = beg; l <= end; l++) knor[l] = 0.0;
+#endif
 }
@@ -0,0 +1,154 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Tile activity mask for explicit tracer diffusion.
+
+  The computational domain is divided into tiles of ::TRACER_TILE_SIZE
+  zones per direction.
+  A tile is \e active when, in the tile or in a halo of
+  ::TRACER_ACTIVE_HALO zones around it, the jump of some tracer across
+  an interface exceeds ::TRACER_ACTIVE_EPS.
+  The halo keeps the mask valid during all stages of the step: a front
+  cannot travel farther than about one zone per stage (hyperbolic CFL
+  plus the diffusion stencil).
+  Tiles touching the local domain boundary are always active, since
+  fronts coming from the ghost zones are not visible in advance.
+
+  Tracer diffusion fluxes vanish in inactive tiles (to within
+  \f$\rho\nu_C\f$ ::TRACER_ACTIVE_EPS \f$/\Delta x\f$), and the pencil
+  sweeps of ParabolicRHS() skip them entirely.
+  Note that a tanh profile does not saturate to the last digit within
+  a few widths, so ::TRACER_ACTIVE_EPS sets the trade-off between the
+  fraction of skipped tiles and the (bounded) error committed there.
+
+  The mask is rebuilt by ParabolicRHS() at the first stage of every
+  explicit step.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if TRACER_ACTIVE_MASK_ON == YES
+
+static unsigned char ***tile_mask;
+static int ntile[3];
+
+/* ********************************************************************* */
+static int TileActive (const ParabolicWork *w, int it, int jt, int kt)
+/*
+ * Activity of tile (it,jt,kt), or of the tiles spanned by the columns
+ * w->i .. w->i + w->nb - 1 when w->nb > 1.
+ *********************************************************************** */
+{
+  int a, alast;
+
+  if (w->nb == 1) return tile_mask[kt][jt][it];
+  alast = (w->i + w->nb - 1 - IBEG)/TRACER_TILE_SIZE;
+  for (a = it; a <= alast; a++) if (tile_mask[kt][jt][a]) return 1;
+  return 0;
+}
+
+/* ********************************************************************* */
+void TracerActiveBuild (const Data *d, Grid *grid)
+/*!
+ * Rebuild the tile activity mask from the current tracer distribution.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int it, jt, kt;
+
+  if (tile_mask == NULL){
+    ntile[IDIR] = (NX1 - 1)/TRACER_TILE_SIZE + 1;
+    ntile[JDIR] = (NX2 - 1)/TRACER_TILE_SIZE + 1;
+    ntile[KDIR] = (NX3 - 1)/TRACER_TILE_SIZE + 1;
+    tile_mask = ARRAY_3D(ntile[KDIR], ntile[JDIR], ntile[IDIR], unsigned char);
+  }
+
+/* --------------------------------------------------------
+   Flag tiles with tracer jumps in the tile or its halo
+   -------------------------------------------------------- */
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) private(it)
+  #endif
+  for (kt = 0; kt < ntile[KDIR]; kt++){
+  for (jt = 0; jt < ntile[JDIR]; jt++){
+    for (it = 0; it < ntile[IDIR]; it++){
+      int i, j, k, n, i0, i1, j0, j1, k0, k1;
+      int active = 0;
+      int h1 = MIN(TRACER_ACTIVE_HALO, TRACER_TILE_SIZE);
+      int h2 = INCLUDE_JDIR*h1, h3 = INCLUDE_KDIR*h1;
+      double ***C;
+
+      i0 = IBEG + it*TRACER_TILE_SIZE; i1 = MIN(i0 + TRACER_TILE_SIZE - 1, IEND);
+      j0 = JBEG + jt*TRACER_TILE_SIZE; j1 = MIN(j0 + TRACER_TILE_SIZE - 1, JEND);
+      k0 = KBEG + kt*TRACER_TILE_SIZE; k1 = MIN(k0 + TRACER_TILE_SIZE - 1, KEND);
+
+      if (   it == 0 || it == ntile[IDIR] - 1
+          || (INCLUDE_JDIR && (jt == 0 || jt == ntile[JDIR] - 1))
+          || (INCLUDE_KDIR && (kt == 0 || kt == ntile[KDIR] - 1))){
+        tile_mask[kt][jt][it] = 1;
+        continue;
+      }
+
+      for (n = 0; n < NTRACER && !active; n++){
+        C = d->Vc[TRC+n];
+        for (k = k0 - h3; k <= k1 + h3 && !active; k++){
+        for (j = j0 - h2; j <= j1 + h2 && !active; j++){
+        for (i = i0 - h1; i <= i1 + h1 - 1; i++){
+          double dC = fabs(C[k][j][i+1] - C[k][j][i]);
+          #if INCLUDE_JDIR
+          dC = MAX(dC, fabs(C[k][j+1][i] - C[k][j][i]));
+          #endif
+          #if INCLUDE_KDIR
+          dC = MAX(dC, fabs(C[k+1][j][i] - C[k][j][i]));
+          #endif
+          if (dC > TRACER_ACTIVE_EPS) {active = 1; break;}
+        }}}
+      }
+      tile_mask[kt][jt][it] = active;
+    }
+  }}
+}
+
+/* ********************************************************************* */
+int TracerActiveRun (const ParabolicWork *w, int l, int end, int *lend)
+/*!
+ * Find the run of consecutive tiles, along the pencil described by w,
+ * that starts at zone l and share its activity.
+ * For a batch of w->nb > 1 adjacent X2 pencils, a tile row is active
+ * when any of the columns is.
+ *
+ * \param [in]  w      pointer to the pencil workspace
+ * \param [in]  l      first zone of the run
+ * \param [in]  end    last zone of the pencil (or pencil segment)
+ * \param [out] lend   last zone of the run (<= end)
+ *
+ * \return 1 if the run is active, 0 otherwise.
+ *********************************************************************** */
+{
+  int dir = w->dir, t, t0, tend, act;
+  int beg0 = (dir == IDIR ? IBEG : (dir == JDIR ? JBEG : KBEG));
+  int it = (w->i - IBEG)/TRACER_TILE_SIZE;
+  int jt = (w->j - JBEG)/TRACER_TILE_SIZE;
+  int kt = (w->k - KBEG)/TRACER_TILE_SIZE;
+  int *tt = (dir == IDIR ? &it : (dir == JDIR ? &jt : &kt));
+
+  t0   = (l   - beg0)/TRACER_TILE_SIZE;
+  tend = (end - beg0)/TRACER_TILE_SIZE;
+
+  *tt = t0;
+  act = TileActive (w, it, jt, kt);
+  for (t = t0 + 1; t <= tend; t++){
+    *tt = t;
+    if (TileActive (w, it, jt, kt) != act) break;
+  }
+  *lend = MIN(beg0 + t*TRACER_TILE_SIZE - 1, end);
+  return act;
+}
+
+#endif /* TRACER_ACTIVE_MASK_ON == YES */
@@ -0,0 +1,327 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Implicit (Crank-Nicolson ADI) tracer diffusion.
+
+  When ::TRACER_DIFFUSION is set to \c ADI, the tracer equation
+  \f[
+    \pd{(\rho C)}{t} = \nabla\cdot\Big(\rho\nu_C\nabla C\Big)
+  \f]
+  is advanced over a whole time step at the beginning of the step,
+  keeping the density fixed, by alternating-direction sweeps: along
+  every pencil of direction d the one-dimensional Crank-Nicolson
+  problem
+  \f[
+    \rho_l\frac{C^*_l - C_l}{\Delta t} = \frac{1}{2\Delta x_l}\Big[
+       F^*_{l+\HALF} - F^*_{l-\HALF} + F_{l+\HALF} - F_{l-\HALF}\Big]
+    \,,\qquad
+    F_{l+\HALF} = \rho_{l+\HALF}\nu_C\frac{C_{l+1} - C_l}{\Delta x_{l+\HALF}}
+  \f]
+  is solved with the same interface averages as the explicit kernel.
+  The order of the directions is reversed every other step.
+
+  Each sweep is a tridiagonal solve, O(N) per pencil, and is
+  unconditionally stable, so the time step is set by the hyperbolic
+  CFL condition alone.
+  In periodic directions the system is cyclic and is solved with the
+  Sherman-Morrison correction; otherwise the ghost values at t^n act
+  as boundary values.
+  Like TRACER_RHS_Batch(), X2 and X3 pencils are processed in
+  batches of ::TRACER_JBATCH adjacent columns, with the column index
+  innermost, and batches are distributed among OpenMP threads.
+
+  As for the other split modes, the increment \f$\Delta(\rho C)\f$ is
+  returned as a rate \f$\Delta(\rho C)/\Delta t\f$ added by
+  ParabolicUpdate() to every stage.
+  Only Cartesian geometry is supported, and the swept directions must
+  not be decomposed among processes.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if TRACER_DIFFUSION == ADI
+
+#ifdef _OPENMP
+ #include <omp.h>
+ #define THREAD_ID  omp_get_thread_num()
+#else
+ #define THREAD_ID  0
+#endif
+
+#define ADI_NB     (TRACER_JBATCH > 1 ? TRACER_JBATCH : 1)
+#define ADI_THETA  0.5       /* Crank-Nicolson */
+
+typedef struct ADIWork_ {
+  double **q, **rho;         /* Tracer and density along the batch [l][c]  */
+  double **a, **b, **c;      /* Sub-, main and super-diagonal               */
+  double **r, **x, **z;      /* Rhs, solution, Sherman-Morrison vector      */
+  double **gam;              /* Thomas algorithm scratch                    */
+} ADIWork;
+
+static ADIWork *ADIGetWork (int);
+static void     ADICheckGrid (Grid *);
+static double  *ADIRow (double ***, int, int, int, int);
+static void     ADISweep (double ***, const Data *, int, double, double,
+                          RBox *, Grid *);
+static void     ADISolve (ADIWork *, int, int, int, int);
+
+/* ********************************************************************* */
+void TracerADIUpdate (const Data *d, double ****dC, RBox *box,
+                      double dt, Grid *grid)
+/*!
+ * Advance the tracers by diffusion over dt and store the conservative
+ * increment divided by dt.
+ *
+ * \param [in]  d      pointer to PLUTO Data structure (state at t^n,
+ *                     boundaries already assigned)
+ * \param [out] dC     the rate dC[TRC+n][k][j][i] = Delta(rho*C_n)/dt
+ * \param [in]  box    box defining the zones to be updated
+ * \param [in]  dt     the time step
+ * \param [in]  grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, s, dir, ndir = 0, dirs[3];
+  static double ***q;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
+
+  if (q == NULL){
+    ADICheckGrid (grid);
+    ADIGetWork (0);
+    q = ARRAY_3D(NX3_MAX, NX2_MAX, NX1_MAX, double);
+  }
+
+  if (INCLUDE_IDIR) dirs[ndir++] = IDIR;
+  if (INCLUDE_JDIR) dirs[ndir++] = JDIR;
+  if (INCLUDE_KDIR) dirs[ndir++] = KDIR;
+
+  for (n = 0; n < NTRACER; n++){
+    TOT_LOOP(k,j,i) q[k][j][i] = d->Vc[TRC+n][k][j][i];
+
+    for (s = 0; s < ndir; s++){
+      dir = (g_stepNumber%2 == 0 ? dirs[s] : dirs[ndir-1-s]);
+      ADISweep (q, d, dir, fabs(dc->nu_trc[n]), dt, box, grid);
+    }
+
+    BOX_LOOP(box,k,j,i){
+      dC[TRC+n][k][j][i] =   d->Vc[RHO][k][j][i]
+                           *(q[k][j][i] - d->Vc[TRC+n][k][j][i])/dt;
+    }
+  }
+}
+
+/* ********************************************************************* */
+static void ADISweep (double ***q, const Data *d, int dir, double nu,
+                      double dt, RBox *box, Grid *grid)
+/*!
+ * Crank-Nicolson step of the tracer q along all the pencils of
+ * direction dir (q is updated in place).
+ *********************************************************************** */
+{
+  int    beg, end, obeg, oend, pbeg, pend, npb, nb, o, pb;
+  int    periodic = (   grid->lbound[dir] == PERIODIC
+                     && grid->rbound[dir] == PERIODIC);
+  double *dx = grid->dx[dir], *inv_dxi = grid->inv_dxi[dir];
+
+  if (dir == IDIR){
+    beg  = box->ibeg; end  = box->iend; nb = 1;
+    obeg = box->kbeg; oend = box->kend;
+    pbeg = box->jbeg; pend = box->jend;
+  }else if (dir == JDIR){
+    beg  = box->jbeg; end  = box->jend; nb = ADI_NB;
+    obeg = box->kbeg; oend = box->kend;
+    pbeg = box->ibeg; pend = box->iend;
+  }else{
+    beg  = box->kbeg; end  = box->kend; nb = ADI_NB;
+    obeg = box->jbeg; oend = box->jend;
+    pbeg = box->ibeg; pend = box->iend;
+  }
+  npb = (pend - pbeg)/nb + 1;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for collapse(2) schedule(static)
+  #endif
+  for (o = obeg; o <= oend; o++){
+  for (pb = 0; pb < npb; pb++){
+    int    l, c, p = pbeg + pb*nb, nc = MIN(nb, pend - p + 1);
+    double g, am, ap, wl, wr;
+    double th = ADI_THETA;
+    ADIWork *w = ADIGetWork (THREAD_ID);
+    double **C = w->q, **R = w->rho;
+
+  /* -- Load the batch, with ghost (or periodic) end values -- */
+
+    for (l = beg-1; l <= end+1; l++){
+      double *ql = ADIRow (q, dir, l, o, p);
+      double *rl = ADIRow (d->Vc[RHO], dir, l, o, p);
+      for (c = 0; c < nc; c++){
+        C[l][c] = ql[c];
+        R[l][c] = rl[c];
+      }
+    }
+    if (periodic) for (c = 0; c < nc; c++){
+      C[beg-1][c] = C[end][c];
+      C[end+1][c] = C[beg][c];
+    }
+
+  /* -- Assemble the system for zones beg..end -- */
+
+    for (l = beg; l <= end; l++){
+      g  = dt/dx[l];
+      wl = dx[l-1]/(dx[l-1] + dx[l]);
+      wr = dx[l+1]/(dx[l] + dx[l+1]);
+      for (c = 0; c < nc; c++){
+        am = nu*(R[l-1][c]*wl + R[l][c]*(1.0 - wl))*inv_dxi[l-1];
+        ap = nu*(R[l][c]*(1.0 - wr) + R[l+1][c]*wr)*inv_dxi[l];
+        w->a[l][c] = -th*g*am;
+        w->c[l][c] = -th*g*ap;
+        w->b[l][c] = R[l][c] + th*g*(am + ap);
+        w->r[l][c] =   R[l][c]*C[l][c]
+                     + (1.0 - th)*g*(  ap*(C[l+1][c] - C[l][c])
+                                     - am*(C[l][c] - C[l-1][c]));
+      }
+    }
+
+  /* -- Non-periodic ends: ghost values are known -- */
+
+    if (!periodic) for (c = 0; c < nc; c++){
+      w->r[beg][c] -= w->a[beg][c]*C[beg-1][c];
+      w->r[end][c] -= w->c[end][c]*C[end+1][c];
+    }
+
+    ADISolve (w, beg, end, nc, periodic);
+
+    for (l = beg; l <= end; l++){
+      double *ql = ADIRow (q, dir, l, o, p);
+      for (c = 0; c < nc; c++) ql[c] = w->x[l][c];
+    }
+  }}
+}
+
+/* ********************************************************************* */
+static void ADISolve (ADIWork *w, int beg, int end, int nc, int periodic)
+/*!
+ * Solve the nc tridiagonal systems a x[l-1] + b x[l] + c x[l+1] = r,
+ * l = beg..end, stored in w (solution in w->x).
+ * When periodic != 0, a[beg] and c[end] couple the first and last
+ * unknowns (cyclic system) and the Sherman-Morrison formula is used:
+ * the modified system is solved for r and for u = (gamma, 0, ..., 0,
+ * c[end]), and the two solutions are combined.
+ * The systems are diagonally dominant, so no pivoting is needed.
+ *********************************************************************** */
+{
+  int    l, c;
+  double **a = w->a, **b = w->b, **cc = w->c, **r = w->r;
+  double **x = w->x, **z = w->z, **gam = w->gam;
+  double gamma[ADI_NB], alpha[ADI_NB], beta[ADI_NB];
+  double bet[ADI_NB], fact;
+
+/* -- Modified diagonal (cyclic case) -- */
+
+  if (periodic) for (c = 0; c < nc; c++){
+    gamma[c] = -b[beg][c];
+    alpha[c] = cc[end][c];
+    beta[c]  = a[beg][c];
+    b[beg][c] -= gamma[c];
+    b[end][c] -= alpha[c]*beta[c]/gamma[c];
+  }
+
+/* -- Forward elimination (both right hand sides) -- */
+
+  for (c = 0; c < nc; c++){
+    bet[c]    = b[beg][c];
+    x[beg][c] = r[beg][c]/bet[c];
+    z[beg][c] = (periodic ? gamma[c] : 0.0)/bet[c];
+  }
+  for (l = beg+1; l <= end; l++){
+    for (c = 0; c < nc; c++){
+      double u = (periodic && l == end ? alpha[c] : 0.0);
+
+      gam[l][c] = cc[l-1][c]/bet[c];
+      bet[c]    = b[l][c] - a[l][c]*gam[l][c];
+      x[l][c]   = (r[l][c] - a[l][c]*x[l-1][c])/bet[c];
+      z[l][c]   = (u       - a[l][c]*z[l-1][c])/bet[c];
+    }
+  }
+
+/* -- Back substitution -- */
+
+  for (l = end-1; l >= beg; l--){
+    for (c = 0; c < nc; c++){
+      x[l][c] -= gam[l+1][c]*x[l+1][c];
+      z[l][c] -= gam[l+1][c]*z[l+1][c];
+    }
+  }
+
+/* -- Sherman-Morrison correction -- */
+
+  if (periodic) for (c = 0; c < nc; c++){
+    fact = (x[beg][c] + beta[c]*x[end][c]/gamma[c])
+          /(1.0 + z[beg][c] + beta[c]*z[end][c]/gamma[c]);
+    for (l = beg; l <= end; l++) x[l][c] -= fact*z[l][c];
+  }
+}
+
+/* ********************************************************************* */
+static double *ADIRow (double ***q, int dir, int l, int o, int p)
+/*!
+ * Address of zone l of the pencil (batch) labeled by (o,p): (k,j) for
+ * IDIR, (k,i) for JDIR and (j,i) for KDIR. Columns of a batch are
+ * contiguous.
+ *********************************************************************** */
+{
+  if      (dir == IDIR) return &q[o][p][l];
+  else if (dir == JDIR) return q[o][l] + p;
+  else                  return q[l][o] + p;
+}
+
+/* ********************************************************************* */
+static ADIWork *ADIGetWork (int tid)
+/*!
+ * Return the scratch of thread tid. All threads' scratch is allocated
+ * during the first call, which must be made outside parallel regions.
+ *********************************************************************** */
+{
+  int n, nthreads = 1;
+  static ADIWork *work;
+
+  if (work == NULL){
+    #ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+    #endif
+    work = ARRAY_1D(nthreads, ADIWork);
+    for (n = 0; n < nthreads; n++){
+      work[n].q   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].rho = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].a   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].b   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].c   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].r   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].x   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].z   = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+      work[n].gam = ARRAY_2D(NMAX_POINT, ADI_NB, double);
+    }
+  }
+  return work + tid;
+}
+
+/* ********************************************************************* */
+static void ADICheckGrid (Grid *grid)
+/*!
+ * Pencil solves need the whole extent of every swept direction.
+ *********************************************************************** */
+{
+  int dir;
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    if (grid->nproc[dir] != 1){
+      printLog ("! TracerADIUpdate(): direction %d must not be decomposed"
+                " among processes\n", dir);
+      QUIT_PLUTO(1);
+    }
+  }
+}
+
+#endif /* TRACER_DIFFUSION == ADI */
@@ -4,7 +4,7 @@
   \brief Compute rhs for thermal conduction 
 
   Compute the one-dimensional right hand side for the
-  thermal conduction operator in the direction given by ::g_dir.
+  thermal conduction operator in the direction of the pencil workspace.
 
   \authors A. Mignone (mignone@ph.unito.it)\n
            A. Dutta
@@ -18,13 +18,17 @@
 #include "local_pluto.h"
 
 /* ********************************************************************* */
-void TRACER_RHS (const Data *d, Data_Arr dU, double *dcoeff,
+void TRACER_RHS (const Data *d, Data_Arr dU, ParabolicWork *w,
              double **aflux, double dt, int beg, int end, Grid *grid)
 /*!
  * \param [in]   d           pointer to PLUTO Data structure
  * \param [out]  dU          a 4D array containing conservative variables
  *                           increment
- * \param [out]  dcoeff      tracer diffusion coefficient 
+ * \param [in,out] w         pointer to the (thread-private) pencil
+ *                           workspace. On input it defines the sweep
+ *                           direction and pencil position; on output
+ *                           w->dcoeff_trc contains the tracer diffusion
+ *                           coefficients.
  * \param [out]  aflux       pointer to 2D array for AMR re-fluxing
  *                           operations
  * \param [in]   dt          the current time-step                            
@@ -33,88 +37,85 @@ void TRACER_RHS (const Data *d, Data_Arr dU, double *dcoeff,
  *
  *********************************************************************** */
 {
-  int i = g_i;
-  int j = g_j;
-  int k = g_k;
-  int nv, trc;
-  double dtdV, dtdx;
-  static  double *fA;
-  static  Sweep sweep;
-  static double **tracer_flux;
+  int i = w->i;
+  int j = w->j;
+  int k = w->k;
+  int m, nv, trc, n;
+  #if GEOMETRY == CARTESIAN
+  double dtdx;
+  #else
+  double dtdV, *fA = w->fA;
+  #endif
+  double **vn = w->vn;
+  double **tracer_flux = w->tracer_flux;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
 
 /* --------------------------------------------------------
-   0. Allocate memory
-   -------------------------------------------------------- */
-  
-  if (sweep.vn == NULL) {
-    MakeState (&sweep);
-    fA = ARRAY_1D(NMAX_POINT, double);
-  }
-  if (tracer_flux == NULL){
-    tracer_flux = ARRAY_2D(NMAX_POINT, NTRACER, double);
-  }
-
-/* --------------------------------------------------------
-   1. Compute RHS tracer flux
+   1. Compute RHS tracer flux.
+      Only the primitives read by the flux kernel
+      (TracerFluxVars) are gathered.
    -------------------------------------------------------- */
  
-  if (g_dir == IDIR) {
-    ITOT_LOOP (i) NVAR_LOOP(nv) sweep.vn[i][nv] = d->Vc[nv][k][j][i];
-  } else if (g_dir == JDIR) {
-    JTOT_LOOP (j) NVAR_LOOP(nv) sweep.vn[j][nv] = d->Vc[nv][k][j][i];
-  } else if (g_dir == KDIR) {
-    KTOT_LOOP (k) NVAR_LOOP(nv) sweep.vn[k][nv] = d->Vc[nv][k][j][i];
+  for (m = 0; m < TRACER_FLUX_NVAR; m++){
+    nv = TracerFluxVars[m];
+    if (w->dir == IDIR) {
+      for (i = beg-1; i <= end+1; i++) vn[i][nv] = d->Vc[nv][k][j][i];
+    } else if (w->dir == JDIR) {
+      for (j = beg-1; j <= end+1; j++) vn[j][nv] = d->Vc[nv][k][j][i];
+    } else if (w->dir == KDIR) {
+      for (k = beg-1; k <= end+1; k++) vn[k][nv] = d->Vc[nv][k][j][i];
+    }
   }
-  RHS_TRACER_Flux (d->Vc+TRC, &sweep, tracer_flux, beg-1, end, grid);
+  i = w->i; j = w->j; k = w->k;
+  RHS_TRACER_Flux (d->Vc+TRC, w, beg-1, end, grid);
 
 /* --------------------------------------------------------
    2. Multiply flux X area & compute rhs
    -------------------------------------------------------- */
   NTRACER_LOOP(trc){  
-    double del_u = 2*g_inputParam[U_FLOW]; // CGS
-    double chi   = g_inputParam[LENGTH]*del_u/g_inputParam[REYNOLDS]; 
-    dcoeff[trc-TRC] = fabs(chi/(UNIT_LENGTH*UNIT_VELOCITY)); /* diffusion coefficients */
+    n = trc - TRC;
+    w->dcoeff_trc[n] = fabs(dc->nu_trc[n]); /* diffusion coefficients */
   
-    if (g_dir == IDIR){
+    if (w->dir == IDIR){
       #if GEOMETRY != CARTESIAN
       for (i = beg-1; i <= end; i++){
-        fA[i] = tracer_flux[i][trc]*grid->A[IDIR][k][j][i];
+        fA[i] = tracer_flux[i][n]*grid->A[IDIR][k][j][i];
       }  
       #endif
       for (i = beg; i <= end; i++){
         #if GEOMETRY == CARTESIAN
         dtdx = dt/grid->dx[IDIR][i];
-        dU[k][j][i][trc] += dtdx*(tracer_flux[i][trc] - tracer_flux[trc][i-1]);
+        dU[k][j][i][trc] += dtdx*(tracer_flux[i][n] - tracer_flux[i-1][n]);
         #else
         dtdV = dt/grid->dV[k][j][i];
         dU[k][j][i][trc] += dtdV*(fA[i] - fA[i-1]);
         #endif
       }    
-    } else if (g_dir == JDIR){
+    } else if (w->dir == JDIR){
       #if GEOMETRY != CARTESIAN
       for (j = beg-1; j <= end; j++){
-        fA[j] = tracer_flux[j][trc]*grid->A[JDIR][k][j][i];
+        fA[j] = tracer_flux[j][n]*grid->A[JDIR][k][j][i];
       }  
       #endif
       for (j = beg; j <= end; j++){
         #if GEOMETRY == CARTESIAN
         dtdx = dt/grid->dx[JDIR][j];
-        dU[k][j][i][trc] += dtdx*(tracer_flux[j][trc] - tracer_flux[trc][j-1]);
+        dU[k][j][i][trc] += dtdx*(tracer_flux[j][n] - tracer_flux[j-1][n]);
         #else
         dtdV = dt/grid->dV[k][j][i];
         dU[k][j][i][trc] += dtdV*(fA[j] - fA[j-1]);
         #endif
       }    
-    } else if (g_dir == KDIR){
+    } else if (w->dir == KDIR){
       #if GEOMETRY != CARTESIAN
       for (k = beg-1; k <= end; k++){
-        fA[k] = tracer_flux[k][trc]*grid->A[KDIR][k][j][i];
+        fA[k] = tracer_flux[k][n]*grid->A[KDIR][k][j][i];
       }  
       #endif
       for (k = beg; k <= end; k++){
         #if GEOMETRY == CARTESIAN
         dtdx = dt/grid->dx[KDIR][k];
-        dU[k][j][i][trc] += dtdx*(tracer_flux[k][trc] - tracer_flux[trc][k-1]);
+        dU[k][j][i][trc] += dtdx*(tracer_flux[k][n] - tracer_flux[k-1][n]);
         #else
         dtdV = dt/grid->dV[k][j][i];
         dU[k][j][i][trc] += dtdV*(fA[k] - fA[k-1]);
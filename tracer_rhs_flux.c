@@ -20,17 +20,28 @@
 #include "pluto.h"
 #include "local_pluto.h"
 
+#if TRACER_UNIFORM_GRID_ON == YES
+static void GetTracerGradientUniform (double ***, double **, int, int,
+                                      const ParabolicWork *, Grid *);
+#endif
+
+/* -- Primitive variables read by RHS_TRACER_Flux() -- */
+
+const int TracerFluxVars[TRACER_FLUX_NVAR] = {RHO};
+
 /* ********************************************************************* */
-void RHS_TRACER_Flux (double ****TracerField, const Sweep *sweep,  
-              double **tracer_flux, int beg, int end, Grid *grid)
+void RHS_TRACER_Flux (double ****TracerField, ParabolicWork *w,
+              int beg, int end, Grid *grid)
 /*! 
- * Compute the thermal conduction flux, sweep->par_flx.
+ * Compute the tracer diffusion flux, w->tracer_flux.
  *
  * \param [in]     TracerField   4D array containing the dimensionless 
  *                               3D tracer fields
- * \param [in] sweep   pointer to a Sweep structure
- * \param [out]    tracer_flux  the flux due to the tracer source
- *                         the time step.
+ * \param [in,out] w       pointer to the pencil workspace; w->vn holds
+ *                         the primitive state along the pencil (only the
+ *                         ::TracerFluxVars need be set) and, on
+ *                         output, w->tracer_flux holds the flux due to
+ *                         the tracer source.
  * \param [in]     beg     initial index of computation
  * \param [in]     end     final   index of computation
  * \param [in]     grid    pointer to an array of Grid structures
@@ -38,41 +49,35 @@ void RHS_TRACER_Flux (double ****TracerField, const Sweep *sweep,
  * \return This function has no return value.                       
  *********************************************************************** */
 {
-  int  i, trc, nv;
+  int  i, trc, m, nv;
+  int  dir = w->dir;
   double Flux;
   double vi[NVAR];
-  double **vc = sweep->vn;
-  static double ***gradTRC;
-  
-  double del_u = 2*g_inputParam[U_FLOW]; // CGS
-  double chi   = g_inputParam[LENGTH]*del_u/g_inputParam[REYNOLDS]; 
-  
-  double nu_dye = (chi/(UNIT_LENGTH*UNIT_VELOCITY));
-
-/* -----------------------------------------------------------
-   1. Allocate memory, compute tracer gradient in the
-      required direction and set 2 out of the 3 coordinates.
-   ----------------------------------------------------------- */
-
-  if (gradTRC == NULL) {
-    gradTRC = ARRAY_3D(NTRACER, NMAX_POINT, 3, double);
-  }
+  double **vc = w->vn;
+  double **tracer_flux = w->tracer_flux;
+  double ***gradTRC    = w->gradTRC;
+  double nu_dye;
+  const DiffusionConstants *dc = DiffusionConstantsGet();
 
 /* ----------------------------------------------- 
-   2. Compute Tracer Difussion Flux (trcflx).
+   1. Compute Tracer Difussion Flux (trcflx).
    ----------------------------------------------- */
   
   for (trc = 0; trc < NTRACER; trc++){  
-    GetTracerGradient (TracerField[trc], gradTRC[trc], beg, end, grid);
+    nu_dye = dc->nu_trc[trc];
+    GetTracerGradient (TracerField[trc], gradTRC[trc], beg, end, w, grid);
     for (i = beg; i <= end; i++){
 
-    /* -- 3a. Compute interface values -- */
+    /* -- 1a. Compute interface values (needed variables only) -- */
 
-      NVAR_LOOP(nv) vi[nv]  = (vc[i][nv]*grid->dx[g_dir][i] + vc[i+1][nv]*grid->dx[g_dir][i+1])/(grid->dx[g_dir][i]+grid->dx[g_dir][i+1]);
+      for (m = 0; m < TRACER_FLUX_NVAR; m++){
+        nv     = TracerFluxVars[m];
+        vi[nv] = (vc[i][nv]*grid->dx[dir][i] + vc[i+1][nv]*grid->dx[dir][i+1])/(grid->dx[dir][i]+grid->dx[dir][i+1]);
+      }
     
-    /* -- 3b. Compute the Tracer flux -- */
+    /* -- 1b. Compute the Tracer flux -- */
        
-      Flux        = vi[RHO]*nu_dye*gradTRC[trc][i][g_dir];  
+      Flux        = vi[RHO]*nu_dye*gradTRC[trc][i][dir];  
       tracer_flux[i][trc] = Flux;
     }
   }
@@ -81,22 +86,22 @@ void RHS_TRACER_Flux (double ****TracerField, const Sweep *sweep,
 
 /* ********************************************************************* */
 void GetTracerGradient (double ***Field, double **gradField, 
-                  int beg, int end, Grid *grid)
+                  int beg, int end, const ParabolicWork *w, Grid *grid)
 /*!
  *   Compute the gradient of a 3D scalar quantity C in the direction
- *   given by g_dir.
+ *   given by w->dir, along the pencil (w->i, w->j, w->k).
  *   Return a 1D array (dField/dx, dField/dy, dField/dz) along that direction 
  *   computed at cell interfaces, e.g.
  *
- *   if g_dir == IDIR  --> compute 
+ *   if w->dir == IDIR  --> compute 
  *  
  *    [ dField/dl1, dField/dl2, dField/dl3 ] at interface (i+1/2,j,k)
  *
- *   if g_dir == JDIR  --> compute 
+ *   if w->dir == JDIR  --> compute 
  *  
  *    [ dField/dl1, dField/dl2, dField/dl3 ] at interface (i,j+1/2,k)
  * 
- *   if g_dir == KDIR  --> compute 
+ *   if w->dir == KDIR  --> compute 
  *  
  *    [ dField/dl1, dField/dl2, dField/dl3 ] at interface (i,j,k+1/2)
  *   
@@ -114,16 +119,22 @@ void GetTracerGradient (double ***Field, double **gradField,
  *   14 Apr 2011 by T. Matsakos, A. Mignone
  *   27 Mar 2023 by A. Dutta
  *
+ *   With ::TRACER_UNIFORM_GRID (Cartesian geometry only) the call is
+ *   forwarded to GetTracerGradientUniform(), which only computes the
+ *   normal component.
  *
  *********************************************************************** */
 {
+#if TRACER_UNIFORM_GRID_ON == YES
+  GetTracerGradientUniform (Field, gradField, beg, end, w, grid);
+#else
   int  i,j,k;
   double *r, *rp;
   double *inv_dx,  *inv_dy,  *inv_dz;
   double *inv_dxi, *inv_dyi, *inv_dzi;
   double dl1, dl2, dl3, theta, r_1, s_1;
   double dx1, dx2, dx3;
-  
+
   inv_dx  = grid->inv_dx[IDIR]; inv_dxi = grid->inv_dxi[IDIR];
   inv_dy  = grid->inv_dx[JDIR]; inv_dyi = grid->inv_dxi[JDIR];
   inv_dz  = grid->inv_dx[KDIR]; inv_dzi = grid->inv_dxi[KDIR];
@@ -131,11 +142,11 @@ void GetTracerGradient (double ***Field, double **gradField,
   r  = grid->x[IDIR];
   rp = grid->xr[IDIR];
 
-  i = g_i;
-  j = g_j;
-  k = g_k;
+  i = w->i;
+  j = w->j;
+  k = w->k;
 
-  if (g_dir == IDIR) {
+  if (w->dir == IDIR) {
 
     #if GEOMETRY == SPHERICAL
     theta = grid->x[JDIR][j];
@@ -163,7 +174,7 @@ void GetTracerGradient (double ***Field, double **gradField,
       )
     }
 
-  }else if (g_dir == JDIR) {
+  }else if (w->dir == JDIR) {
 
     r_1  = 1.0/r[i];
     DIM_EXPAND(
@@ -190,7 +201,7 @@ void GetTracerGradient (double ***Field, double **gradField,
       )
     }
   
-  }else if (g_dir == KDIR){
+  }else if (w->dir == KDIR){
 
     dl1 = inv_dx[i];            
     dl2 = inv_dy[j]; 
@@ -215,4 +226,62 @@ void GetTracerGradient (double ***Field, double **gradField,
       gradField[k][2] = (Field[k+1][j][i] - Field[k][j][i])*dl3;
     }
   }
+#endif /* TRACER_UNIFORM_GRID_ON */
+}
+
+#if TRACER_UNIFORM_GRID_ON == YES
+/* ********************************************************************* */
+static void GetTracerGradientUniform (double ***Field, double **gradField,
+                                      int beg, int end,
+                                      const ParabolicWork *w, Grid *grid)
+/*!
+ * Cartesian, uniform-grid version of GetTracerGradient().
+ * Only the normal component gradField[l][w->dir], the one entering
+ * the flux, is computed, with the constant interface spacing taken
+ * at the first interface.
+ * Transverse components are left untouched.
+ *********************************************************************** */
+{
+  int    l, i = w->i, j = w->j, k = w->k, dir = w->dir;
+  double inv_d = grid->inv_dxi[dir][beg];
+
+  if (dir == IDIR){
+    double *q = Field[k][j];
+    for (l = beg; l <= end; l++) gradField[l][IDIR] = (q[l+1] - q[l])*inv_d;
+  }else if (dir == JDIR){
+    for (l = beg; l <= end; l++){
+      gradField[l][JDIR] = (Field[k][l+1][i] - Field[k][l][i])*inv_d;
+    }
+  }else if (dir == KDIR){
+    for (l = beg; l <= end; l++){
+      gradField[l][KDIR] = (Field[l+1][j][i] - Field[l][j][i])*inv_d;
+    }
+  }
+}
+
+/* ********************************************************************* */
+void TracerCheckUniformGrid (Grid *grid)
+/*!
+ * Abort if the local grid is not uniform in some direction, since
+ * GetTracerGradientUniform() assumes constant spacing.
+ *
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    dir, l, beg, end;
+  double d0;
+
+  for (dir = 0; dir < DIMENSIONS; dir++){
+    beg = grid->lbeg[dir] - 1;
+    end = grid->lend[dir];
+    d0  = grid->inv_dxi[dir][beg];
+    for (l = beg; l <= end; l++){
+      if (fabs(grid->inv_dxi[dir][l] - d0) > 1.e-9*fabs(d0)){
+        printLog ("! TracerCheckUniformGrid(): TRACER_UNIFORM_GRID requires ");
+        printLog ("a uniform grid (dir = %d)\n", dir);
+        QUIT_PLUTO(1);
+      }
+    }
+  }
 }
+#endif /* TRACER_UNIFORM_GRID_ON == YES */
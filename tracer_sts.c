@@ -0,0 +1,237 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Operator-split super-time-stepping for tracer diffusion.
+
+  When ::TRACER_DIFFUSION is set to \c SUPER_TIME_STEPPING or
+  \c RK_LEGENDRE, the tracer equation
+  \f[
+    \pd{(\rho C)}{t} = \nabla\cdot\Big(\rho\nu_C\nabla C\Big)
+  \f]
+  is advanced over a whole time step \f$\Delta t\f$ at the beginning of
+  the step, keeping the density fixed.
+  The sub-steps are taken either with classic STS (Alexiades et al.,
+  first order in time) or with the second-order Runge-Kutta-Legendre
+  scheme RKL2 (Meyer et al. 2014), with the same formulation used by
+  the core for thermal conduction and viscosity.
+  Each sub-step evaluates the right hand side with ParabolicRHS() on a
+  shallow copy of the data structure in which only the tracer arrays
+  are replaced, followed by a call to Boundary() on the copy, so that
+  the tracer arrays of \c d are never modified.
+
+  The increment \f$\Delta(\rho C)\f$ is returned as a rate
+  \f$\Delta(\rho C)/\Delta t\f$: ParabolicUpdate() adds it to every
+  Runge-Kutta stage so that, stage weights summing to one, the full
+  increment is recovered at the end of the step.
+
+  \b References
+     - "Numerical solution of diffusion problems by super time
+        stepping" Alexiades, Amiez & Gremaud, Com. Num. Meth. Eng. (1996)
+     - "A stabilized Runge-Kutta-Legendre method for explicit
+        super-time-stepping of parabolic and mixed equations"
+        Meyer, Balsara & Aslam, JCP (2014) 257A, 594
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#if (PARABOLIC_FLUX != NO) && ((TRACER_DIFFUSION == SUPER_TIME_STEPPING) || \
+                               (TRACER_DIFFUSION == RK_LEGENDRE))
+
+#define STS_MAX_STEPS  1024
+
+static double STS_Sum (int, double);
+
+/* ********************************************************************* */
+void TracerSplitUpdate (const Data *d, double ****dC, RBox *box,
+                        double dt, Grid *grid)
+/*!
+ * Advance the tracers by diffusion over dt and store the conservative
+ * increment divided by dt.
+ *
+ * \param [in]  d      pointer to PLUTO Data structure (state at t^n,
+ *                     boundaries already assigned)
+ * \param [out] dC     the rate dC[TRC+n][k][j][i] = Delta(rho*C_n)/dt
+ * \param [in]  box    box defining the zones to be updated
+ * \param [in]  dt     the time step
+ * \param [in]  grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, nv, s, m;
+  static double ****rhs, ****Y0, ****Ya, ****Yb, ****Yc, ****L0;
+  double ***Vc[NVAR], ****Yjm1, ****Yjm2, ****Yj;
+  double invDt, dt_expl;
+  double rho;
+  Data   ds = *d;
+
+  if (rhs == NULL){
+    rhs = ARRAY_4D(NX3_MAX, NX2_MAX, NX1_MAX, NVAR, double);
+    Y0  = ARRAY_4D(NTRACER, NX3_MAX, NX2_MAX, NX1_MAX, double);
+    Ya  = ARRAY_4D(NTRACER, NX3_MAX, NX2_MAX, NX1_MAX, double);
+    Yb  = ARRAY_4D(NTRACER, NX3_MAX, NX2_MAX, NX1_MAX, double);
+    Yc  = ARRAY_4D(NTRACER, NX3_MAX, NX2_MAX, NX1_MAX, double);
+    L0  = ARRAY_4D(NTRACER, NX3_MAX, NX2_MAX, NX1_MAX, double);
+  }
+
+/* --------------------------------------------------------
+   1. Work on a shallow copy of d whose tracer arrays point
+      to the sub-step state.
+   -------------------------------------------------------- */
+
+  NVAR_LOOP(nv) Vc[nv] = d->Vc[nv];
+  ds.Vc = Vc;
+
+  for (n = 0; n < NTRACER; n++) {
+    TOT_LOOP(k,j,i) Y0[n][k][j][i] = d->Vc[TRC+n][k][j][i];
+  }
+
+/* --------------------------------------------------------
+   2. Right hand side at t^n and explicit time step.
+      The density does not change, so neither does dt_expl.
+   -------------------------------------------------------- */
+
+  invDt = ParabolicRHS (&ds, rhs, box, NULL, TRACER_SPLIT_STEP, 1.0, grid);
+  BOX_LOOP(box,k,j,i){
+    rho = d->Vc[RHO][k][j][i];
+    for (n = 0; n < NTRACER; n++) L0[n][k][j][i] = rhs[k][j][i][TRC+n]/rho;
+  }
+
+  if (invDt <= 0.0){
+    BOX_LOOP(box,k,j,i) NTRACER_LOOP(nv) dC[nv][k][j][i] = 0.0;
+    return;
+  }
+  dt_expl = RuntimeGet()->cfl_par/(2.0*invDt);
+
+#if TRACER_DIFFUSION == SUPER_TIME_STEPPING
+
+/* --------------------------------------------------------
+   3a. Classic STS: N forward Euler sub-steps of size
+       tau_m = dt_expl/[(nu - 1)cos(pi(2m-1)/2N) + 1 + nu],
+       with dt_expl rescaled so that sum(tau_m) = dt.
+   -------------------------------------------------------- */
+
+  {
+    double nu = TRACER_STS_NU, tau;
+
+    for (s = 1; s < STS_MAX_STEPS; s++){
+      if (dt_expl*STS_Sum(s, nu) >= dt) break;
+    }
+    if (s == STS_MAX_STEPS){
+      printLog ("! TracerSplitUpdate(): too many STS steps (%d)\n", s);
+      QUIT_PLUTO(1);
+    }
+    dt_expl = dt/STS_Sum(s, nu);
+
+    Yj = Ya;
+    for (m = 1; m <= s; m++){
+      tau = dt_expl/((nu - 1.0)*cos(CONST_PI*(2.0*m - 1.0)/(2.0*s)) + 1.0 + nu);
+
+      if (m > 1){
+        ParabolicRHS (&ds, rhs, box, NULL, TRACER_SPLIT_STEP, 1.0, grid);
+      }
+      BOX_LOOP(box,k,j,i){
+        rho = d->Vc[RHO][k][j][i];
+        for (n = 0; n < NTRACER; n++){
+          Yj[n][k][j][i] = Vc[TRC+n][k][j][i] + tau*rhs[k][j][i][TRC+n]/rho;
+        }
+      }
+      for (n = 0; n < NTRACER; n++) Vc[TRC+n] = Yj[n];
+      Boundary (&ds, ALL_DIR, grid);
+      Yj = (Yj == Ya ? Yb : Ya);
+    }
+    Yj = (Yj == Ya ? Yb : Ya);   /* Last updated state */
+  }
+
+#elif TRACER_DIFFUSION == RK_LEGENDRE
+
+/* --------------------------------------------------------
+   3b. RKL2: s (odd) stages with
+       dt <= dt_expl*(s^2 + s - 2)/4
+   -------------------------------------------------------- */
+
+  {
+    double w1, mu, nu, mut, gmt;
+    double b[3], bj;   /* b[0] = b_{j-2}, b[1] = b_{j-1}, b[2] = b_j */
+    double ****Ytmp;
+
+    s = (int)ceil(0.5*(sqrt(9.0 + 16.0*dt/dt_expl) - 1.0));
+    s = MAX(s, 2);
+    if (s%2 == 0) s++;
+    w1 = 4.0/(s*s + s - 2.0);
+
+  /* -- Stage 1 -- */
+
+    mut = w1/3.0;
+    BOX_LOOP(box,k,j,i){
+      for (n = 0; n < NTRACER; n++){
+        Ya[n][k][j][i] = Y0[n][k][j][i] + mut*dt*L0[n][k][j][i];
+      }
+    }
+    for (n = 0; n < NTRACER; n++) Vc[TRC+n] = Ya[n];
+    Boundary (&ds, ALL_DIR, grid);
+
+    Yjm2 = Y0; Yjm1 = Ya; Yj = Yb;
+    b[0] = b[1] = 1.0/3.0;
+
+  /* -- Stages 2..s -- */
+
+    for (m = 2; m <= s; m++){
+      bj  = (m == 2 ? 1.0/3.0 : (m*m + m - 2.0)/(2.0*m*(m + 1.0)));
+      b[2] = bj;
+      mu  = (2.0*m - 1.0)/m*b[2]/b[1];
+      nu  = -(m - 1.0)/m*b[2]/b[0];
+      mut = mu*w1;
+      gmt = -(1.0 - b[1])*mut;
+
+      ParabolicRHS (&ds, rhs, box, NULL, TRACER_SPLIT_STEP, 1.0, grid);
+      BOX_LOOP(box,k,j,i){
+        rho = d->Vc[RHO][k][j][i];
+        for (n = 0; n < NTRACER; n++){
+          Yj[n][k][j][i] =   mu*Yjm1[n][k][j][i] + nu*Yjm2[n][k][j][i]
+                          + (1.0 - mu - nu)*Y0[n][k][j][i]
+                          + mut*dt*rhs[k][j][i][TRC+n]/rho
+                          + gmt*dt*L0[n][k][j][i];
+        }
+      }
+      for (n = 0; n < NTRACER; n++) Vc[TRC+n] = Yj[n];
+      Boundary (&ds, ALL_DIR, grid);
+
+    /* -- Rotate stage buffers (Y0 is never overwritten) -- */
+
+      Ytmp = (Yjm2 == Y0 ? Yc : Yjm2);
+      Yjm2 = Yjm1; Yjm1 = Yj; Yj = Ytmp;
+      b[0] = b[1]; b[1] = b[2];
+    }
+    Yj = Yjm1;   /* Last updated state */
+  }
+#endif
+
+/* --------------------------------------------------------
+   4. Conservative increment rate
+   -------------------------------------------------------- */
+
+  BOX_LOOP(box,k,j,i){
+    rho = d->Vc[RHO][k][j][i];
+    for (n = 0; n < NTRACER; n++){
+      dC[TRC+n][k][j][i] = rho*(Yj[n][k][j][i] - Y0[n][k][j][i])/dt;
+    }
+  }
+}
+
+/* ********************************************************************* */
+static double STS_Sum (int N, double nu)
+/*!
+ * Return sum(tau_m)/dt_expl for N classic STS sub-steps
+ * with damping factor nu.
+ *********************************************************************** */
+{
+  double a, b, sq = sqrt(nu);
+
+  a = pow(1.0 + sq, 2.0*N);
+  b = pow(1.0 - sq, 2.0*N);
+  return N/(2.0*sq)*(a - b)/(a + b);
+}
+
+#endif /* TRACER_DIFFUSION == SUPER_TIME_STEPPING || RK_LEGENDRE */
@@ -3,6 +3,7 @@
  *  \brief Specification of explicit first and second viscosity coefficients*/
 /* /////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
+#include "local_pluto.h"
 /* ************************************************************************** */
 void Visc_nu(double *v, double x1, double x2, double x3,
                         double *nu1, double *nu2)
@@ -17,9 +18,38 @@ void Visc_nu(double *v, double x1, double x2, double x3,
  *
  *  \return This function has no return value.
  * ************************************************************************** */
-{ double del_u = 2*g_inputParam[U_FLOW]; // CGS
-  double chi   = g_inputParam[LENGTH]*del_u/g_inputParam[REYNOLDS]; 
+{ const DiffusionConstants *dc = DiffusionConstantsGet();
   
-  *nu1 = v[RHO]*(chi/(UNIT_LENGTH*UNIT_VELOCITY));
+  *nu1 = v[RHO]*dc->nu_visc;
   *nu2 = 0.0;
 }
+
+/* ************************************************************************** */
+void Visc_nuPencil(double **v, int beg, int end, const ParabolicWork *w,
+                   Grid *grid, double *nu1, double *nu2)
+/*!
+ * Pencil version of Visc_nu(): fill the viscosity coefficients at the
+ * interfaces beg..end of the pencil described by w.
+ * Interface l lies between zones l and l+1 along w->dir, at
+ * grid->xr[w->dir][l]; the other coordinates are those of zone
+ * (w->i, w->j, w->k).
+ *
+ *  \param [in]      v    interface states, v[nv][l]
+ *  \param [in]      beg  first interface
+ *  \param [in]      end  last interface
+ *  \param [in]      w    pointer to the pencil workspace
+ *  \param [in]      grid pointer to Grid structure
+ *  \param [out]     nu1  first viscous coefficient, nu1[l]
+ *  \param [out]     nu2  second viscous coefficient, nu2[l]
+ *
+ *  \return This function has no return value.
+ * ************************************************************************** */
+{ int    l;
+  double nu    = DiffusionConstantsGet()->nu_visc;
+  double *rho  = v[RHO];
+
+  for (l = beg; l <= end; l++){
+    nu1[l] = rho[l]*nu;
+    nu2[l] = 0.0;
+  }
+}
@@ -0,0 +1,246 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Horizontally averaged profile output.
+
+  Writes the x-averaged (x- and z-averaged in 3D) profiles of selected
+  primitive variables, and optionally their variance, as a function of
+  y to the binary time series \c xavg.bin in the output directory.
+  The output is configured by a line in the [Static Grid Output]
+  block of pluto.ini:
+  \verbatim
+  xavg   <dt>   <mode>   <var1> <var2> ...
+  \endverbatim
+  where \c mode is \c mean or \c mean+var and variables are named as
+  in OutputVarName() (\c rho, \c vx1, \c vx2, \c vx3, \c prs, \c tr1,
+  ...). Profiles are stored in the order of the variables, not of the
+  line; names that are not variables are ignored.
+  Profiles are taken by XAvgCheck(), called from Analysis(), so that
+  output times are rounded to the \c analysis interval.
+
+  Averages are volume-weighted: every rank sums over its own zones and
+  the partial sums are reduced on rank 0, which writes the file.
+
+  File layout (native endianness):
+  - header, written at the first step of a run:
+    <tt>int nvar, int ny, int with_var, char name[nvar][8],
+        double y[ny]</tt>;
+  - one record per output:
+    <tt>double t, double mean[nvar][ny]</tt> and, with \c mean+var,
+    <tt>double var[nvar][ny]</tt>.
+
+  \date    Oct 16, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "local_pluto.h"
+
+#define XAVG_MAX_VARS  16
+
+/* ********************************************************************* */
+void XAvgCheck (const Data *d, Grid *grid)
+/*!
+ * Read the xavg line of pluto.ini at the first call, and write the
+ * profiles when a multiple of the output interval has been reached
+ * since the last output.
+ *
+ * \param [in] d      pointer to PLUTO Data structure
+ * \param [in] grid   pointer to Grid structure
+ *********************************************************************** */
+{
+  static int    nvar = -1, with_var, var[XAVG_MAX_VARS], last = -1;
+  static double dt_out;
+  int  n, nv;
+  char *mode, name[16];
+
+  if (nvar == -1){
+    nvar = 0;
+    if (!ParamExist ("xavg")) return;
+    dt_out   = atof(ParamFileGet("xavg", 1));
+    mode     = ParamFileGet("xavg", 2);
+    with_var = (strcmp(mode, "mean+var") == 0);
+    if (!with_var && strcmp(mode, "mean") != 0){
+      printLog ("! XAvgCheck(): xavg mode must be 'mean' or 'mean+var'\n");
+      QUIT_PLUTO(1);
+    }
+
+  /* -- ParamFileGet() aborts past the last field: look for
+        every variable name on the line instead -- */
+
+    for (nv = 0; nv < NVAR && nvar < XAVG_MAX_VARS; nv++){
+      OutputVarName (nv, name);
+      if (ParamFileHasBoth ("xavg", name)) var[nvar++] = nv;
+    }
+    if (nvar == 0){
+      printLog ("! XAvgCheck(): no known variable in the xavg line\n");
+      QUIT_PLUTO(1);
+    }
+  }
+  if (nvar == 0 || dt_out <= 0.0) return;
+
+  n = (int)floor(g_time/dt_out + 1.e-9);
+  if (n <= last) return;
+  last = n;
+
+  XAvgWrite (d, var, nvar, with_var, grid);
+}
+
+/* ********************************************************************* */
+void XAvgWrite (const Data *d, int *var, int nvar, int with_var,
+                Grid *grid)
+/*!
+ * Compute and append one record of horizontally averaged profiles.
+ *
+ * \param [in] d         pointer to PLUTO Data structure
+ * \param [in] var       indices of the variables to be averaged
+ * \param [in] nvar      number of variables
+ * \param [in] with_var  when != 0, also write the variance
+ * \param [in] grid      pointer to Grid structure
+ *********************************************************************** */
+{
+  int    j, m, ny, joff, nf;
+  long   size;
+  double *sum, *tot, *vsum = NULL, *vtot = NULL;
+  char   fname[512], label[8];
+  FILE  *fp;
+
+/* --------------------------------------------------------
+   1. Partial sums on the global row index.
+      Fields are: weight, y and nvar sums of q.
+   -------------------------------------------------------- */
+
+  ny   = (DIMENSIONS > 1 ? grid->np_int_glob[JDIR] : 1);
+  joff = (DIMENSIONS > 1 ? grid->beg[JDIR] - grid->nghost[JDIR] : 0);
+  nf   = 2 + nvar;
+  size = (long)nf*ny;
+  sum  = ARRAY_1D(size, double);
+  tot  = ARRAY_1D(size, double);
+  for (m = 0; m < size; m++) sum[m] = 0.0;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for private(m)
+  #endif
+  for (j = JBEG; j <= JEND; j++){
+    int    i, k, jg = j - JBEG + joff;
+    double w;
+
+    for (k = KBEG; k <= KEND; k++){
+    for (i = IBEG; i <= IEND; i++){
+      w = grid->dV[k][j][i];
+      sum[0*ny + jg] += w;
+      sum[1*ny + jg] += w*grid->x[JDIR][j];
+      for (m = 0; m < nvar; m++){
+        sum[(2 + m)*ny + jg] += w*d->Vc[var[m]][k][j][i];
+      }
+    }}
+  }
+
+/* -- Every rank needs the means for the variance pass -- */
+
+  #ifdef PARALLEL
+  if (with_var) MPI_Allreduce (sum, tot, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  else          MPI_Reduce (sum, tot, size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  #else
+  for (m = 0; m < size; m++) tot[m] = sum[m];
+  #endif
+
+  if (prank == 0 || with_var){
+    for (j = 0; j < ny; j++){
+      double W = tot[j];
+      tot[ny + j] /= W;
+      for (m = 0; m < nvar; m++) tot[(2 + m)*ny + j] /= W;
+    }
+  }
+
+/* --------------------------------------------------------
+   2. Variance as the mean of (q - <q>)^2 (second pass),
+      which does not lose the fluctuations of fields with
+      a large mean (e.g. pressure) to cancellation
+   -------------------------------------------------------- */
+
+  if (with_var){
+    size = (long)nvar*ny;
+    vsum = ARRAY_1D(size, double);
+    vtot = ARRAY_1D(size, double);
+    for (m = 0; m < size; m++) vsum[m] = 0.0;
+
+    #ifdef _OPENMP
+    #pragma omp parallel for private(m)
+    #endif
+    for (j = JBEG; j <= JEND; j++){
+      int    i, k, jg = j - JBEG + joff;
+      double w, dq;
+
+      for (k = KBEG; k <= KEND; k++){
+      for (i = IBEG; i <= IEND; i++){
+        w = grid->dV[k][j][i];
+        for (m = 0; m < nvar; m++){
+          dq = d->Vc[var[m]][k][j][i] - tot[(2 + m)*ny + jg];
+          vsum[m*ny + jg] += w*dq*dq;
+        }
+      }}
+    }
+
+    #ifdef PARALLEL
+    MPI_Reduce (vsum, vtot, size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    #else
+    for (m = 0; m < size; m++) vtot[m] = vsum[m];
+    #endif
+    if (prank == 0){
+      for (m = 0; m < nvar; m++) for (j = 0; j < ny; j++) vtot[m*ny + j] /= tot[j];
+    }
+  }
+
+/* --------------------------------------------------------
+   3. Rank 0 writes
+   -------------------------------------------------------- */
+
+  if (prank == 0){
+    sprintf (fname, "%s/xavg.bin", RuntimeGet()->output_dir);
+    fp = fopen(fname, g_stepNumber == 0 ? "wb" : "ab");
+    if (fp == NULL){
+      printLog ("! XAvgWrite(): cannot open %s\n", fname);
+    }else{
+      if (g_stepNumber == 0){
+        fwrite (&nvar, sizeof(int), 1, fp);
+        fwrite (&ny, sizeof(int), 1, fp);
+        fwrite (&with_var, sizeof(int), 1, fp);
+        for (m = 0; m < nvar; m++){
+          memset (label, 0, sizeof(label));
+          OutputVarName (var[m], label);
+          fwrite (label, 1, sizeof(label), fp);
+        }
+        fwrite (tot + ny, sizeof(double), ny, fp);
+      }
+      fwrite (&g_time, sizeof(double), 1, fp);
+      fwrite (tot + 2*ny, sizeof(double), (long)nvar*ny, fp);
+      if (with_var) fwrite (vtot, sizeof(double), (long)nvar*ny, fp);
+      fclose (fp);
+    }
+  }
+
+  FreeArray1D ((void *) sum);
+  FreeArray1D ((void *) tot);
+  if (with_var){
+    FreeArray1D ((void *) vsum);
+    FreeArray1D ((void *) vtot);
+  }
+}
+
+/* ********************************************************************* */
+void OutputVarName (int nv, char *name)
+/*!
+ * Short name (at most 7 characters) of the primitive variable nv,
+ * used to label user output.
+ *********************************************************************** */
+{
+  if      (nv == RHO) sprintf (name, "rho");
+  else if (nv == VX1) sprintf (name, "vx1");
+  else if (nv == VX2) sprintf (name, "vx2");
+  else if (nv == VX3) sprintf (name, "vx3");
+  #if HAVE_ENERGY
+  else if (nv == PRS) sprintf (name, "prs");
+  #endif
+  else if (nv >= TRC && nv < TRC + NTRACER) sprintf (name, "tr%d", nv - TRC + 1);
+  else sprintf (name, "var%02d", nv);
+}